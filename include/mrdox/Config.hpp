@@ -66,6 +66,19 @@ public:
         */
         bool multiPage = false;
 
+        /** When the files of a multi-page generator are flushed to stable storage.
+
+            This is `none` to leave flushing to the
+            operating system, `files` to flush each
+            file as it is written, or `finish` to
+            flush all of them when generation ends.
+        */
+        std::string fsync = "none";
+
+        /** `true` if the files of a multi-page generator are written to one archive.
+        */
+        bool archive = false;
+
         //--------------------------------------------
 
         /** Full path to the working directory
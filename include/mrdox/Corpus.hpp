@@ -16,6 +16,7 @@
 #include <mrdox/Config.hpp>
 #include <mrdox/Metadata.hpp>
 #include <memory>
+#include <span>
 #include <string>
 #include <type_traits>
 #include <utility>
@@ -24,6 +25,32 @@
 namespace clang {
 namespace mrdox {
 
+/** The kinds of references from one symbol to another.
+
+    Each kind names the symbols which refer
+    to a given symbol, the reverse of a
+    relation stored in the metadata.
+*/
+enum class XRefKind
+{
+    /** The records which derive directly from a record.
+    */
+    Derived,
+
+    /** The specializations of a primary template.
+    */
+    Specializations,
+
+    /** The functions, fields, variables, and typedefs
+        whose declared type names a symbol.
+    */
+    ReferencedBy,
+
+    /** The records which declare a symbol as a friend.
+    */
+    FriendOf
+};
+
 /** The collection of declarations in extracted form.
 */
 class MRDOX_VISIBLE
@@ -51,6 +78,9 @@ public:
     Config const& config;
 
     /** Return a sorted index of all symbols.
+
+        The index is sorted by symbol ID, so the
+        order is the same from run to run.
     */
     MRDOX_DECL
     virtual
@@ -70,6 +100,118 @@ public:
     Info const*
     find(SymbolID const& id) const noexcept = 0;
 
+    /** Return the symbols with a fully qualified name.
+
+        More than one symbol may have the same name,
+        such as a set of overloaded functions. The
+        default implementation searches the index.
+
+        @param name The fully qualified name,
+        such as "std::vector::push_back".
+
+        @param ignoreCase If `true`, names which
+        differ only in case also match.
+    */
+    MRDOX_DECL
+    virtual
+    std::vector<Info const*>
+    findByName(
+        std::string_view name,
+        bool ignoreCase = false) const;
+
+    /** Return the symbols whose fully qualified name starts with a prefix.
+
+        The symbols are returned in order of name.
+        The default implementation searches the index.
+
+        @param prefix The beginning of the name.
+
+        @param ignoreCase If `true`, the prefix
+        is matched without regard to case.
+
+        @param limit The largest number of
+        symbols to return.
+    */
+    MRDOX_DECL
+    virtual
+    std::vector<Info const*>
+    findByPrefix(
+        std::string_view prefix,
+        bool ignoreCase = false,
+        std::size_t limit = std::size_t(-1)) const;
+
+    /** Return the interface of a record.
+
+        The interfaces of all records are computed
+        once, when the corpus is built. This returns
+        nullptr if the interface was not computed,
+        which is what the default implementation does.
+    */
+    MRDOX_DECL
+    virtual
+    Interface const*
+    findInterface(
+        RecordInfo const& I) const noexcept;
+
+    /** Return the overload sets of a namespace.
+
+        The overload sets of all namespaces are
+        computed once, when the corpus is built.
+        This returns nullptr if the overload sets
+        were not computed, which is what the
+        default implementation does.
+    */
+    MRDOX_DECL
+    virtual
+    NamespaceOverloads const*
+    findOverloads(
+        NamespaceInfo const& I) const noexcept;
+
+    /** Return the symbols which refer to a symbol.
+
+        The references are computed once, when the
+        corpus is built. The symbols are in the same
+        order as the index. The default implementation
+        returns an empty list.
+
+        @param I The symbol which is referred to.
+
+        @param kind The kind of reference.
+    */
+    MRDOX_DECL
+    virtual
+    std::span<Info const* const>
+    findXRefs(
+        Info const& I,
+        XRefKind kind) const noexcept;
+
+    /** Return the safe name of a symbol.
+
+        A safe name is unique without regard to
+        case and is valid in filenames and URLs.
+        This returns an empty string if the safe
+        names were not computed, which is what the
+        default implementation does.
+    */
+    MRDOX_DECL
+    virtual
+    std::string_view
+    getSafeName(
+        SymbolID const& id) const noexcept;
+
+    /** Return the stored fully qualified name of a symbol.
+
+        This returns an empty string if the name
+        was not computed, which is what the default
+        implementation does. Use @ref getFullyQualifiedName
+        to obtain the name in every case.
+    */
+    MRDOX_DECL
+    virtual
+    std::string_view
+    qualifiedName(
+        Info const& I) const noexcept;
+
     /** Return true if an Info with the specified symbol ID exists.
     */
     bool
@@ -19,13 +19,48 @@
 #include <mrdox/Config.hpp>
 #include <mrdox/Corpus.hpp>
 #include <mrdox/Support/Error.hpp>
+#include <memory>
 #include <ostream>
 #include <string>
 #include <string_view>
+#include <vector>
 
 namespace clang {
 namespace mrdox {
 
+/** Renders the documentation of individual symbols.
+
+    A renderer keeps the state needed to render,
+    such as the loaded templates, between calls.
+    It may be called from several threads at once.
+*/
+class MRDOX_VISIBLE
+    SymbolRenderer
+{
+public:
+    /** Destructor.
+    */
+    MRDOX_DECL
+    virtual
+    ~SymbolRenderer() noexcept;
+
+    /** Render the documentation for one symbol.
+
+        @return The error, if any occurred.
+
+        @param dest The string to hold the result.
+
+        @param I The symbol to emit, which must
+        belong to the corpus of the renderer.
+    */
+    MRDOX_DECL
+    virtual
+    Error
+    render(
+        std::string& dest,
+        Info const& I) = 0;
+};
+
 /** Base class for documentation generators.
 */
 class MRDOX_VISIBLE
@@ -133,6 +168,8 @@ public:
 
         @param fileName The file to write. If the
         file already exists, it will be overwritten.
+        When the name ends in `.gz` or `.zst`, the
+        output is compressed as it is generated.
 
         @param corpus The metadata to emit.
     */
@@ -157,8 +194,50 @@ public:
     buildOneString(
         std::string& dest,
         Corpus const& corpus) const;
+
+    /** Return a renderer for individual symbols.
+
+        The renderer prepares the templates once,
+        so callers which render many symbols should
+        keep it rather than make a new one each time.
+        The default implementation returns an error
+        indicating that the generator does not
+        support rendering a single symbol.
+
+        @param corpus The metadata containing
+        the symbols. It must outlive the renderer.
+    */
+    MRDOX_DECL
+    virtual
+    Expected<std::unique_ptr<SymbolRenderer>>
+    makeSymbolRenderer(
+        Corpus const& corpus) const;
 };
 
+/** Build the reference with several generators.
+
+    Each generator runs on its own thread, and
+    they share the thread pool of the corpus for
+    their work. The time taken by each generator
+    is reported.
+
+    @return The errors of the generators which
+    failed, or success if none failed.
+
+    @param generators The generators to run.
+
+    @param outputPath The directory or file
+    passed to each @ref Generator::build.
+
+    @param corpus The symbols to emit.
+*/
+MRDOX_DECL
+Error
+buildAll(
+    std::vector<Generator const*> const& generators,
+    std::string_view outputPath,
+    Corpus const& corpus);
+
 } // mrdox
 } // clang
 
@@ -96,6 +96,11 @@ public:
     dom::Value
     getJavadoc(
         Javadoc const& jd) const;
+
+    /** Return the number of symbols with a cached Dom object.
+    */
+    std::size_t
+    cachedCount() const;
 };
 
 } // mrdox
@@ -64,6 +64,7 @@ public:
 
 private:
     class Build;
+    friend class InterfaceCache;
 
     explicit Interface(Corpus const&) noexcept;
 
@@ -80,6 +81,10 @@ private:
 
 /** Return the composite interface for a record.
 
+    The members inherited from each base which
+    is in the corpus are included, with the
+    access they have in the derived record.
+
     @return The interface.
 
     @param I The interface to store the results in.
@@ -16,8 +16,12 @@
 #include <mrdox/Platform.hpp>
 #include <mrdox/Dom.hpp>
 #include <mrdox/Support/Error.hpp>
+#include <cstddef>
+#include <cstdint>
 #include <memory>
+#include <new>
 #include <string>
+#include <string_view>
 #include <type_traits>
 #include <utility>
 #include <vector>
@@ -33,9 +37,72 @@ struct Node;
 
 using String = std::string;
 
+/** Destroys a node without releasing its storage.
+
+    Nodes are allocated from the @ref Arena of
+    the javadoc which owns them, and the memory
+    is released all at once with the arena.
+*/
+struct NodeDeleter
+{
+    void operator()(Node* p) const noexcept;
+};
+
+template<typename T>
+requires std::derived_from<T, doc::Node>
+using Pointer = std::unique_ptr<T, NodeDeleter>;
+
 template<typename T>
 requires std::derived_from<T, doc::Node>
-using List = std::vector<std::unique_ptr<T>>;
+using List = std::vector<Pointer<T>>;
+
+/** Chunked storage for the nodes of a javadoc.
+
+    Nodes are placed one after another in large
+    chunks of memory instead of being allocated
+    individually on the heap. Merging javadocs
+    moves the chunks, so nodes are never copied.
+
+    Lists still hold a pointer to each node, and
+    the text of a node is a separate string.
+*/
+class MRDOX_DECL
+    Arena
+{
+    std::vector<std::unique_ptr<std::byte[]>> chunks_;
+    std::byte* pos_ = nullptr;
+    std::size_t avail_ = 0;
+    std::size_t next_ = 0;
+
+public:
+    Arena() noexcept = default;
+    Arena(Arena&& other) noexcept;
+    Arena& operator=(Arena&& other) noexcept;
+
+    /** Return uninitialized storage.
+    */
+    void*
+    allocate(
+        std::size_t size,
+        std::size_t align);
+
+    /** Construct a node in the arena.
+    */
+    template<std::derived_from<Node> T, class... Args>
+    Pointer<T>
+    create(Args&&... args)
+    {
+        return Pointer<T>(::new(allocate(
+            sizeof(T), alignof(T))) T(
+                std::forward<Args>(args)...));
+    }
+
+    /** Take ownership of the storage of another arena.
+
+        Nodes allocated from `other` remain valid.
+    */
+    void adopt(Arena&& other);
+};
 
 enum class Kind
 {
@@ -115,6 +182,14 @@ struct MRDOX_DECL
     }
 };
 
+inline
+void
+NodeDeleter::
+operator()(Node* p) const noexcept
+{
+    p->~Node();
+}
+
 //------------------------------------------------
 //
 // Text nodes
@@ -247,9 +322,9 @@ struct MRDOX_DECL
     }
 
     template<std::derived_from<Text> T>
-    void emplace_back(T&& text)
+    void emplace_back(Arena& arena, T&& text)
     {
-        emplace_back(std::make_unique<T>(std::move(text)));
+        emplace_back(arena.create<T>(std::move(text)));
     }
 
     void append(List<Node>&& blocks);
@@ -265,7 +340,7 @@ protected:
     }
 
 private:
-    void emplace_back(std::unique_ptr<Text> text);
+    void emplace_back(Pointer<Text> text);
 };
 
 /** A manually specified section heading.
@@ -569,7 +644,7 @@ visit(
 template<class F, class T, class... Args>
 requires std::derived_from<T, Node>
 void traverse(
-    std::vector<std::unique_ptr<T>> const& list,
+    List<T> const& list,
     F&& f, Args&&... args)
 {
     for(auto const& node : list)
@@ -587,6 +662,29 @@ struct Overview
     std::vector<TParam const*> tparams;
 };
 
+/** The text of a comment which was not parsed.
+*/
+struct RawText
+{
+    /** The comment, including the comment markers.
+    */
+    std::string text;
+
+    /** A hash of the text.
+    */
+    std::uint64_t hash = 0;
+
+    /** The custom block commands of the translation unit.
+
+        These are the names given with
+        `-fcomment-block-commands`, which change
+        how the comment is parsed.
+    */
+    std::vector<std::string> blockCommands;
+
+    bool operator==(RawText const&) const noexcept = default;
+};
+
 MRDOX_DECL dom::String toString(Style style) noexcept;
 
 } // doc
@@ -599,46 +697,159 @@ class MRDOX_DECL
     Javadoc
 {
 public:
+    /** A function which parses the text of a comment.
+
+        This is used to parse the comments which
+        were appended without parsing. It receives
+        the comment including the comment markers,
+        with the options it was read with.
+    */
+    using Parser = Javadoc(*)(doc::RawText const& raw);
+
     /** Constructor.
     */
     MRDOX_DECL
     Javadoc() noexcept;
 
+    /** Destructor.
+    */
+    MRDOX_DECL
+    ~Javadoc();
+
+    /** Constructor
+
+        @param arena The storage for the nodes.
+
+        @param blocks The top level blocks, which
+        must have been allocated from `arena`.
+    */
+    Javadoc(
+        doc::Arena arena,
+        doc::List<doc::Block> blocks);
+
     /** Constructor
+
+        The javadoc refers to the nodes of `shared`
+        instead of copying them, until it is changed.
+
+        @param shared A javadoc which has no
+        pending comments, and is not changed
+        while it is shared.
     */
     explicit
     Javadoc(
-        doc::List<doc::Block> blocks);
+        std::shared_ptr<Javadoc const> shared) noexcept;
+
+    Javadoc(Javadoc&&) noexcept;
+    Javadoc& operator=(Javadoc&&) noexcept;
 
     /** Return true if this is empty
+
+        Comments which have not been parsed
+        yet are parsed first, since they may
+        not produce any nodes.
     */
     bool
-    empty() const noexcept
+    empty() const
     {
-        return blocks_.empty();
+        return getBlocks().empty();
     }
 
     /** Return the brief, or nullptr if there is none.
     */
     doc::Paragraph const*
-    brief() const noexcept;
+    brief() const;
 
     /** Return the list of top level blocks.
+
+        Comments which have not been parsed
+        yet are parsed on the first call.
     */
     doc::List<doc::Block> const&
-    getBlocks() const noexcept
+    getBlocks() const
     {
+        if(shared_)
+            return shared_->getBlocks();
+        if(pending_)
+            parsePending();
         return blocks_;
     }
 
     // VFALCO This is unfortunately necessary for
     //        the deserialization from bitcode...
     doc::List<doc::Block>&
-    getBlocks() noexcept
+    getBlocks()
+    {
+        unshare();
+        if(pending_)
+            parsePending();
+        return blocks_;
+    }
+
+    /** Return the top level blocks which were already parsed.
+
+        Unlike @ref getBlocks, this does not parse
+        pending comments. It is used to serialize
+        a javadoc along with its pending comments,
+        and must not be called while another thread
+        could be parsing them.
+    */
+    doc::List<doc::Block> const&
+    getParsedBlocks() const noexcept
     {
+        if(shared_)
+            return shared_->getParsedBlocks();
         return blocks_;
     }
 
+    /** Return the comments which have not been parsed.
+    */
+    std::vector<doc::RawText>
+    getPending() const;
+
+    /** Return a hash of the comments this was parsed from.
+
+        Javadocs with the same non-zero hash were
+        parsed from the same comments, and compare
+        equal without looking at the nodes. A
+        value of zero means the hash is unknown.
+    */
+    std::uint64_t
+    hash() const noexcept
+    {
+        if(shared_)
+            return shared_->hash();
+        return hash_;
+    }
+
+    /** Set the hash of the comments this was parsed from.
+    */
+    void
+    setHash(std::uint64_t hash)
+    {
+        unshare();
+        hash_ = hash;
+    }
+
+    /** Return a copy of this javadoc.
+
+        The nodes are copied, unless this refers
+        to a shared javadoc, in which case the
+        copy refers to it as well.
+    */
+    MRDOX_DECL
+    Javadoc
+    clone() const;
+
+    /** Return the storage used for the nodes.
+    */
+    doc::Arena&
+    arena()
+    {
+        unshare();
+        return arena_;
+    }
+
     //--------------------------------------------
 
     /** Comparison
@@ -648,8 +859,8 @@ public:
         output format.
     */
     /** @{ */
-    bool operator==(Javadoc const&) const noexcept;
-    bool operator!=(Javadoc const&) const noexcept;
+    bool operator==(Javadoc const&) const;
+    bool operator!=(Javadoc const&) const;
     /* @} */
 
     /** Return an overview of the javadoc.
@@ -680,18 +891,51 @@ public:
     std::string
     emplace_back(T&& block)
     {
-        return emplace_back(std::make_unique<T>(std::move(block)));
+        return emplace_back(arena().create<T>(std::move(block)));
     }
 
     /** Append blocks from another javadoc to this.
+
+        The storage of `other` is adopted
+        so the nodes are not copied.
     */
     void append(Javadoc&& other);
 
+    /** Append blocks allocated from @ref arena.
+    */
     void append(doc::List<doc::Node>&& blocks);
 
+    /** Append the text of a comment without parsing it.
+
+        The text is parsed with `parser` and appended
+        to the blocks when they are first accessed.
+        Text which is already pending is ignored.
+        Every pending comment of a javadoc is parsed
+        with the same parser.
+    */
+    void appendRaw(std::string text, Parser parser);
+
+    /** Append the text of a comment without parsing it.
+    */
+    void appendRaw(doc::RawText raw, Parser parser);
+
 private:
-    std::string emplace_back(std::unique_ptr<doc::Block>);
+    struct Pending;
+
+    std::string emplace_back(doc::Pointer<doc::Block>);
+    void parsePending() const;
+
+    // Copy the nodes of the shared javadoc
+    // so that they can be changed.
+    void unshare();
+
+    std::unique_ptr<Pending> pending_;
+    std::shared_ptr<Javadoc const> shared_;
 
+    // must be declared before the
+    // nodes so it is destroyed after
+    doc::Arena arena_;
+    std::uint64_t hash_ = 0;
     doc::Paragraph const* brief_ = nullptr;
     doc::List<doc::Block> blocks_;
 };
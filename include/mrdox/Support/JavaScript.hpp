@@ -99,6 +99,19 @@ public:
     /** Constructor.
     */
     Context(Context const&) noexcept;
+
+    /** Set the number of fields copied into each object.
+
+        When a dom::Object is given to a script, up
+        to `n` of its null, boolean, integer, and string
+        fields become plain properties, which scripts
+        read without calling back into C++. The other
+        fields are produced when they are read.
+        The default is zero.
+    */
+    void
+    setEagerFields(
+        std::size_t n);
 };
 
 //------------------------------------------------
@@ -126,6 +139,22 @@ public:
     Error
     script(std::string_view jsCode);
 
+    /** Compile a script to bytecode without running it.
+
+        The bytecode may be run in any context with
+        @ref scriptFromBytecode, which is faster than
+        compiling the script again in each context.
+    */
+    MRDOX_DECL
+    Expected<std::string>
+    compile(std::string_view jsCode);
+
+    /** Run a script compiled with @ref compile.
+    */
+    MRDOX_DECL
+    Error
+    scriptFromBytecode(std::string_view bytecode);
+
     /** Return the global object.
     */
     MRDOX_DECL
@@ -15,6 +15,7 @@
 #include <mrdox/Platform.hpp>
 #include <mrdox/Support/any_callable.hpp>
 #include <mrdox/Support/Error.hpp>
+#include <cstddef>
 #include <memory>
 #include <type_traits>
 #include <utility>
@@ -28,6 +29,7 @@ class ThreadPoolTaskGroup;
 namespace clang {
 namespace mrdox {
 
+class MemoryGate;
 class TaskGroup;
 
 //------------------------------------------------
@@ -37,6 +39,8 @@ class TaskGroup;
 class MRDOX_VISIBLE
     ThreadPool
 {
+    // declared first so it outlives the threads
+    std::unique_ptr<MemoryGate> gate_;
     std::unique_ptr<llvm::ThreadPool> impl_;
 
     friend class TaskGroup;
@@ -76,6 +80,26 @@ public:
     unsigned
     getThreadCount() const noexcept;
 
+    /** Limit concurrency while memory usage is high.
+
+        When the memory used by the process exceeds
+        the limit, submitted work runs one item at a
+        time until the usage drops below the limit.
+        Only work submitted from outside the pool is
+        held back. Work submitted by other work runs
+        normally, since its submitter may be waiting
+        for it. A limit of zero removes the limit.
+
+        The behavior is undefined if there is
+        any outstanding work.
+
+        @param bytes The limit in bytes.
+    */
+    MRDOX_DECL
+    void
+    setMemoryLimit(
+        std::size_t bytes);
+
     /** Submit work to be executed.
 
         The signature of the submitted function
@@ -9,11 +9,14 @@
 //
 
 #include "Builder.hpp"
+#include "lib/Support/GeneratorHelpers.hpp"
 #include "lib/Support/Radix.hpp"
 #include <mrdox/Metadata/DomMetadata.hpp>
 #include <mrdox/Support/Path.hpp>
 #include <llvm/Support/FileSystem.h>
+#include <llvm/Support/JSON.h>
 #include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
 #include <fmt/format.h>
 
 namespace clang {
@@ -25,45 +28,62 @@ extern void lua_dump(dom::Object const& obj);
 
 namespace html {
 
-Builder::
-Builder(
-    DomCorpus const& domCorpus,
-    Options const& options)
-    : domCorpus_(domCorpus)
-    , corpus_(domCorpus_.corpus)
-    , options_(options)
+namespace {
+
+// Return the options for compiling and rendering templates
+dom::Object
+templateOptions()
 {
-    namespace fs = llvm::sys::fs;
-    namespace path = llvm::sys::path;
+    dom::Object options;
+    options.set("allowProtoPropertiesByDefault", true);
+    // VFALCO This makes Proxy objects stop working
+    //options.set("allowProtoMethodsByDefault", true);
+    return options;
+}
 
-    Config const& config = corpus_.config;
+} // (anon)
 
-    js::Scope scope(ctx_);
+Expected<std::string>
+Builder::
+compileScripts(
+    Corpus const& corpus)
+{
+    Config const& config = corpus.config;
 
-    scope.script(files::getFileText(
+    auto handlebarsText = files::getFileText(
         files::appendPath(
-            config->addonsDir, "js", "handlebars.js")
-        ).value()).maybeThrow();
-    auto Handlebars = scope.getGlobal("Handlebars").value();
+            config->addonsDir, "js", "handlebars.js"));
+    if(! handlebarsText)
+        return handlebarsText.error();
 
-// VFALCO refactor this
-Handlebars.setlog();
+    js::Context ctx;
+    js::Scope scope(ctx);
+    if(auto err = scope.script(*handlebarsText))
+        return err;
 
-    // load templates
-#if 0
-    err = forEachFile(options_.template_dir,
-        [&](std::string_view fileName)
-        {
-            if(! fileName.ends_with(".html.hbs"))
-                return Error::success();
-            return Error::success();
-        });
-#endif
+    std::string script = std::move(*handlebarsText);
+    script += '\n';
 
-    Error err;
+    // Handlebars.compile works on a copy of its
+    // options, while Handlebars.precompile adds to
+    // the object it is given. The partials are
+    // compiled the same way as the layouts which
+    // used to compile them, from a fresh copy.
+    if(auto err = scope.script(R"(
+        function precompilePartial(text, options)
+        {
+            return Handlebars.precompile(text,
+                Handlebars.Utils.extend({}, options));
+        }
+        )"))
+        return err;
+    auto precompilePartial = scope.getGlobal("precompilePartial");
+    if(! precompilePartial)
+        return precompilePartial.error();
 
-    // load partials
-    forEachFile(
+    // load partials, precompiled here so
+    // that no context compiles them again
+    if(auto err = forEachFile(
         files::appendPath(config->addonsDir,
             "generator", "html", "partials"),
         [&](std::string_view pathName)
@@ -76,37 +96,29 @@ Handlebars.setlog();
             auto text = files::getFileText(pathName);
             if(! text)
                 return text.error();
-            return Handlebars.callProp(
-                "registerPartial", name, *text).error();
-        }).maybeThrow();
-
-    // load helpers
-#if 0
-    err = forEachFile(
-        files::appendPath(config->addonsDir,
-            "generator", "js", "helpers"),
-        [&](std::string_view pathName)
-        {
-            constexpr std::string_view ext = ".js";
-            if(! pathName.ends_with(ext))
-                return Error::success();
-            auto name = files::getFileName(pathName);
-            name.remove_suffix(ext.size());
-            //Handlebars.callProp("registerHelper", name, *text);
-            auto err = ctx_.scriptFromFile(pathName);
+            auto spec = precompilePartial->call(
+                *text, templateOptions());
+            if(! spec)
+                return spec.error();
+            std::string quotedName;
+            llvm::raw_string_ostream(quotedName) <<
+                llvm::json::Value(name);
+            script += fmt::format(
+                "Handlebars.registerPartial({}, Handlebars.template({}));\n",
+                quotedName, spec->getString());
             return Error::success();
-        }).maybeThrow();
-#endif
+        }))
+        return err;
 
-    scope.script(fmt::format(
+    script += fmt::format(
         R"(Handlebars.registerHelper(
             'is_multipage', function()
         {{
             return {};
         }});
-        )", config->multiPage)).maybeThrow();
+        )", config->multiPage);
 
-    scope.script(R"(
+    script += R"(
         Handlebars.registerHelper(
             'to_string', function(context, depth)
         {
@@ -142,7 +154,91 @@ Handlebars.setlog();
         {
             return a && b;
         });
-    )").maybeThrow();
+    )";
+
+    // compiled layouts, by name
+    script += R"(
+        var layouts = {};
+
+        function compileLayout(name, text, options)
+        {
+            layouts[name] = Handlebars.compile(text, options);
+        }
+
+        function callLayout(name, context, options)
+        {
+            return layouts[name](context, options);
+        }
+    )";
+
+    return scope.compile(script);
+}
+
+Expected<std::shared_ptr<Handlebars const>>
+Builder::
+makeHandlebars(
+    Corpus const& corpus)
+{
+    Config const& config = corpus.config;
+
+    auto hbs = std::make_shared<Handlebars>();
+    if(auto err = forEachFile(
+        files::appendPath(config->addonsDir,
+            "generator", "html", "partials"),
+        [&](std::string_view pathName)
+        {
+            constexpr std::string_view ext = ".html.hbs";
+            if(! pathName.ends_with(ext))
+                return Error::success();
+            auto name = files::getFileName(pathName);
+            name.remove_suffix(ext.size());
+            auto text = files::getFileText(pathName);
+            if(! text)
+                return text.error();
+            hbs->registerPartial(name, *text);
+            return Error::success();
+        }))
+        return err;
+    registerGeneratorHelpers(*hbs, config);
+    return hbs;
+}
+
+Builder::
+Builder(
+    DomCorpus const& domCorpus,
+    Options const& options,
+    std::string_view bytecode)
+    : domCorpus_(domCorpus)
+    , corpus_(domCorpus_.corpus)
+    , options_(options)
+{
+    runScripts(bytecode);
+}
+
+Builder::
+Builder(
+    DomCorpus const& domCorpus,
+    Options const& options,
+    std::shared_ptr<Handlebars const> hbs)
+    : domCorpus_(domCorpus)
+    , corpus_(domCorpus_.corpus)
+    , options_(options)
+    , hbs_(std::move(hbs))
+{
+}
+
+void
+Builder::
+runScripts(
+    std::string_view bytecode)
+{
+    ctx_.emplace().setEagerFields(options_.eager_fields);
+    js::Scope scope(*ctx_);
+    scope.scriptFromBytecode(bytecode).maybeThrow();
+    auto Handlebars = scope.getGlobal("Handlebars").value();
+
+// VFALCO refactor this
+Handlebars.setlog();
 }
 
 //------------------------------------------------
@@ -155,22 +251,55 @@ callTemplate(
 {
     Config const& config = corpus_.config;
 
-    js::Scope scope(ctx_);
-    auto Handlebars = scope.getGlobal("Handlebars");
     auto layoutDir = files::appendPath(config->addonsDir,
             "generator", "html", "layouts");
     auto pathName = files::appendPath(layoutDir, name);
-    auto fileText = files::getFileText(pathName);
-    if(! fileText)
-        return fileText.error();
-    dom::Object options;
-    options.set("allowProtoPropertiesByDefault", true);
-    // VFALCO This makes Proxy objects stop working
-    //options.set("allowProtoMethodsByDefault", true);
-    auto templateFn = Handlebars->callProp("compile", *fileText, options);
-    if(! templateFn)
-        return templateFn.error();
-    auto result = templateFn->call(context, options);
+
+    // Each layout is read and compiled once. A
+    // Builder lives for one build, so changes to
+    // the layouts are seen by the next build.
+    auto it = layouts_.find(name);
+    bool const found = it != layouts_.end();
+    if(! found)
+    {
+        auto fileText = files::getFileText(pathName);
+        if(! fileText)
+            return fileText.error();
+        it = layouts_.try_emplace(name, std::move(*fileText)).first;
+    }
+
+    if(hbs_)
+    {
+        HandlebarsOptions options;
+        try
+        {
+            return hbs_->render(it->second, context, options);
+        }
+        catch(std::exception const& ex)
+        {
+            return formatError("rendering \"{}\" failed: {}", pathName, ex.what());
+        }
+    }
+
+    js::Scope scope(*ctx_);
+    auto options = templateOptions();
+    if(! found)
+    {
+        auto compileLayout = scope.getGlobal("compileLayout");
+        if(! compileLayout)
+            return compileLayout.error();
+        auto err = compileLayout->call(name, it->second, options).error();
+        it->second.clear();
+        if(err)
+        {
+            layouts_.erase(it);
+            return err;
+        }
+    }
+    auto callLayout = scope.getGlobal("callLayout");
+    if(! callLayout)
+        return callLayout.error();
+    auto result = callLayout->call(name, context, options);
     if(! result)
         return result.error();
     return result->getString();
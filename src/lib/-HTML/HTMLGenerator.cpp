@@ -14,10 +14,14 @@
 #include "Builder.hpp"
 #include "MultiPageVisitor.hpp"
 #include "SinglePageVisitor.hpp"
+#include "lib/Support/Memory.hpp"
 #include "lib/Support/SafeNames.hpp"
 #include <mrdox/Metadata/DomMetadata.hpp>
 #include <mrdox/Support/Error.hpp>
 #include <mrdox/Support/Path.hpp>
+#include <mrdox/Support/ThreadPool.hpp>
+#include <memory>
+#include <mutex>
 #include <optional>
 #include <vector>
 
@@ -35,20 +39,133 @@ createExecutors(
 
     auto const& config = domCorpus.corpus.config;
     auto& threadPool = config.threadPool();
+    std::vector<std::optional<Builder>> builders(
+        threadPool.getThreadCount());
+
+    // The native engine is shared by every Builder
+    if(options->engine == "native")
+    {
+        auto hbs = Builder::makeHandlebars(domCorpus.corpus);
+        if(! hbs)
+            return hbs.error();
+        for(auto& builder : builders)
+            builder.emplace(domCorpus, *options, *hbs);
+    }
+    else
+    {
+        // The scripts are compiled once, and
+        // each Builder runs the bytecode.
+        auto bytecode = Builder::compileScripts(domCorpus.corpus);
+        if(! bytecode)
+            return bytecode.error();
+
+        TaskGroup taskGroup(threadPool);
+        for(std::size_t i = 0; i < builders.size(); ++i)
+        {
+            taskGroup.async(
+                [&, i]
+                {
+                    builders[i].emplace(domCorpus, *options, *bytecode);
+                });
+        }
+        auto errors = taskGroup.wait();
+        if(! errors.empty())
+            return Error(errors);
+    }
+
     ExecutorGroup<Builder> group(threadPool);
-    for(auto i = threadPool.getThreadCount(); i--;)
+    for(auto& builder : builders)
+        group.emplace(std::move(*builder));
+    return group;
+}
+
+//------------------------------------------------
+
+namespace {
+
+/*  Renders single symbols with Builders which
+    are kept between calls. Each call takes an
+    idle Builder, or makes one from the scripts
+    compiled when the renderer was created.
+*/
+class HTMLSymbolRenderer
+    : public SymbolRenderer
+{
+    HTMLCorpus domCorpus_;
+    Options options_;
+    std::string bytecode_;
+    std::shared_ptr<Handlebars const> hbs_;
+
+    std::mutex mutex_;
+    std::vector<std::unique_ptr<Builder>> idle_;
+
+    std::unique_ptr<Builder>
+    acquire()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if(! idle_.empty())
+            {
+                auto builder = std::move(idle_.back());
+                idle_.pop_back();
+                return builder;
+            }
+        }
+        if(hbs_)
+            return std::make_unique<Builder>(
+                domCorpus_, options_, hbs_);
+        return std::make_unique<Builder>(
+            domCorpus_, options_, bytecode_);
+    }
+
+    void
+    release(std::unique_ptr<Builder> builder)
     {
+        std::lock_guard<std::mutex> lock(mutex_);
+        idle_.emplace_back(std::move(builder));
+    }
+
+public:
+    HTMLSymbolRenderer(
+        Corpus const& corpus,
+        Options options)
+        : domCorpus_(corpus)
+        , options_(std::move(options))
+    {
+        if(options_.engine == "native")
+            hbs_ = Builder::makeHandlebars(corpus).value();
+        else
+            bytecode_ = Builder::compileScripts(corpus).value();
+    }
+
+    Error
+    render(
+        std::string& dest,
+        Info const& I) override
+    {
+        dest.clear();
         try
         {
-           group.emplace(domCorpus, *options);
+            auto builder = acquire();
+            auto text = visit(I,
+                [&](auto const& J)
+                {
+                    return (*builder)(J);
+                });
+            release(std::move(builder));
+            if(! text)
+                return text.error();
+            dest = std::move(*text);
         }
         catch(Exception const& ex)
         {
             return ex.error();
         }
+        return Error::success();
     }
-    return group;
-}
+};
+
+} // (anon)
 
 //------------------------------------------------
 //
@@ -70,12 +187,15 @@ build(
     if(! ex)
         return ex.error();
 
-    MultiPageVisitor visitor(*ex, outputPath, corpus);
+    OutputFiles output(outputPath, "html", corpus.config);
+    MultiPageVisitor visitor(*ex, output, corpus);
     visitor(corpus.globalNamespace());
     auto errors = ex->wait();
+    memoryReport().record("html.dom-cache",
+        domCorpus.cachedCount(), 0);
     if(! errors.empty())
         return Error(errors);
-    return Error::success();
+    return output.finish();
 }
 
 Error
@@ -104,6 +224,11 @@ buildOne(
     SinglePageVisitor visitor(*ex, corpus, os);
     visitor(corpus.globalNamespace());
     errors = ex->wait();
+    visitor.finish();
+    memoryReport().record("html.pages",
+        visitor.peakPages(), visitor.peakBytes());
+    memoryReport().record("html.dom-cache",
+        domCorpus.cachedCount(), 0);
     if(! errors.empty())
         return Error(errors);
 
@@ -120,6 +245,25 @@ buildOne(
     return Error::success();
 }
 
+Expected<std::unique_ptr<SymbolRenderer>>
+HTMLGenerator::
+makeSymbolRenderer(
+    Corpus const& corpus) const
+{
+    auto options = loadOptions(corpus);
+    if(! options)
+        return options.error();
+    try
+    {
+        return std::make_unique<HTMLSymbolRenderer>(
+            corpus, std::move(*options));
+    }
+    catch(Exception const& ex)
+    {
+        return ex.error();
+    }
+}
+
 } // html
 
 //------------------------------------------------
@@ -50,6 +50,10 @@ public:
     buildOne(
         std::ostream& os,
         Corpus const& corpus) const override;
+
+    Expected<std::unique_ptr<SymbolRenderer>>
+    makeSymbolRenderer(
+        Corpus const& corpus) const override;
 };
 
 } // html
@@ -10,7 +10,6 @@
 
 #include "MultiPageVisitor.hpp"
 #include <mrdox/Support/Path.hpp>
-#include <fstream>
 
 namespace clang {
 namespace mrdox {
@@ -37,23 +36,9 @@ renderPage(
         [this, &I](Builder& builder)
         {
             auto pageText = builder(I).value();
-
-            std::string fileName = files::appendPath(
-                outputPath_, toBase16(I.id) + ".html");
-            std::ofstream os;
-            try
-            {
-                os.open(fileName,
-                    std::ios_base::binary |
-                        std::ios_base::out |
-                        std::ios_base::trunc // | std::ios_base::noreplace
-                    );
-                os.write(pageText.data(), pageText.size());
-            }
-            catch(std::exception const& ex)
-            {
-                formatError("std::ofstream(\"{}\") threw \"{}\"", fileName, ex.what()).Throw();
-            }
+            files_.write(
+                toBase16(I.id) + ".html",
+                std::move(pageText)).maybeThrow();
         });
 }
 
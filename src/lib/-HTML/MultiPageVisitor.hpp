@@ -12,6 +12,7 @@
 #define MRDOX_LIB_HTML_MULTIPAGEVISITOR_HPP
 
 #include "Builder.hpp"
+#include "lib/Support/OutputFiles.hpp"
 #include <mrdox/Support/ExecutorGroup.hpp>
 #include <mutex>
 #include <ostream>
@@ -27,16 +28,16 @@ namespace html {
 class MultiPageVisitor
 {
     ExecutorGroup<Builder>& ex_;
-    std::string_view outputPath_;
+    OutputFiles& files_;
     Corpus const& corpus_;
 
 public:
     MultiPageVisitor(
         ExecutorGroup<Builder>& ex,
-        std::string_view outputPath,
+        OutputFiles& files,
         Corpus const& corpus) noexcept
         : ex_(ex)
-        , outputPath_(outputPath)
+        , files_(files)
         , corpus_(corpus)
     {
     }
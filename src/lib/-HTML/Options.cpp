@@ -59,6 +59,8 @@ struct llvm::yaml::MappingTraits<
         auto& opt= yk.opt;
         io.mapOptional("safe-names",  opt.safe_names);
         io.mapOptional("template-dir",  opt.template_dir);
+        io.mapOptional("engine",  opt.engine);
+        io.mapOptional("eager-fields",  opt.eager_fields);
     }
 };
 
@@ -122,6 +124,10 @@ loadOptions(
             return Error(ec);
     }
 
+    if(opt.engine != "js" && opt.engine != "native")
+        return formatError(
+            "the template engine \"{}\" is not js or native", opt.engine);
+
     // adjust relative paths
 
     if(! opt.template_dir.empty())
@@ -27,6 +27,22 @@ struct Options
 {
     bool safe_names = false;
     std::string template_dir;
+
+    /** The engine which renders the templates.
+
+        This is "js" to render with handlebars.js,
+        or "native" to render with the C++ engine.
+    */
+    std::string engine = "js";
+
+    /** The number of scalar fields copied into each object.
+
+        With the "js" engine, up to this many scalar
+        fields of each object are given to the scripts
+        as plain properties, which are faster to read.
+        Zero reads every field on demand.
+    */
+    unsigned eager_fields = 32;
 };
 
 /** Return loaded Options from a configuration.
@@ -17,8 +17,10 @@
 #include "lib/Support/Radix.hpp"
 #include "lib/Support/SafeNames.hpp"
 #include <mrdox/Platform.hpp>
+#include <mrdox/Support/ThreadPool.hpp>
 #include <llvm/Support/YAMLParser.h>
 #include <llvm/Support/YAMLTraits.h>
+#include <algorithm>
 
 //------------------------------------------------
 //
@@ -151,7 +153,8 @@ build()
     if(options_.index || options_.safe_names)
         writeIndex();
 
-    visit(corpus_.globalNamespace(), *this);
+    if(auto err = writeSymbols())
+        return err;
 
     if(options_.prolog)
         os_ << "</mrdox>\n";
@@ -194,12 +197,95 @@ writeIndex()
 
 //------------------------------------------------
 
+Error
+XMLWriter::
+writeSymbols()
+{
+    // With one thread, the symbols are written in place
+    auto& threadPool = corpus_.config.threadPool();
+    if(threadPool.getThreadCount() <= 1)
+    {
+        visit(corpus_.globalNamespace(), *this);
+        return Error::success();
+    }
+
+    std::string outline;
+    std::vector<Member> members;
+    {
+        llvm::raw_string_ostream os(outline);
+        XMLWriter writer(os, corpus_);
+        writer.options_ = options_;
+        writer.tags_.indent_ = tags_.indent_;
+        writer.members_ = &members;
+        visit(corpus_.globalNamespace(), writer);
+    }
+
+    // Each task writes a run of members, and the
+    // window bounds the text held at one time.
+    std::size_t const n = members.size();
+    std::size_t const chunk = 64;
+    std::size_t const window =
+        chunk * 4 * threadPool.getThreadCount();
+    std::vector<std::string> text;
+    llvm::StringRef rest(outline);
+    std::uint64_t pos = 0;
+    for(std::size_t first = 0; first < n; first += window)
+    {
+        std::size_t const last = std::min(first + window, n);
+        text.assign(last - first, {});
+        TaskGroup taskGroup(threadPool);
+        for(std::size_t i = first; i < last; i += chunk)
+        {
+            taskGroup.async(
+                [&, i]
+                {
+                    std::size_t const end = std::min(i + chunk, last);
+                    for(std::size_t j = i; j < end; ++j)
+                        writeMember(members[j], text[j - first]);
+                });
+        }
+        auto errors = taskGroup.wait();
+        if(! errors.empty())
+            return Error(errors);
+        for(std::size_t i = first; i < last; ++i)
+        {
+            os_ << rest.slice(pos, members[i].offset) << text[i - first];
+            pos = members[i].offset;
+        }
+    }
+    os_ << rest.substr(pos);
+    return Error::success();
+}
+
+void
+XMLWriter::
+writeMember(
+    Member const& M,
+    std::string& text)
+{
+    llvm::raw_string_ostream os(text);
+    XMLWriter writer(os, corpus_);
+    writer.options_ = options_;
+    writer.tags_.indent_ = M.indent;
+    visit(*M.I, writer);
+}
+
+//------------------------------------------------
+
 template<class T>
 void
 XMLWriter::
 operator()(
     T const& I)
 {
+    if constexpr(! T::isNamespace())
+    {
+        if(members_)
+        {
+            members_->push_back({ &I, tags_.indent_, os_.tell() });
+            return;
+        }
+    }
     if constexpr(T::isNamespace())
     {
         tags_.open(namespaceTagName, {
@@ -533,8 +619,11 @@ writeJavadoc(
 {
     if(! javadoc)
         return;
+    // read through const, which
+    // does not copy shared nodes
+    Javadoc const& jd = *javadoc;
     tags_.open(javadocTagName);
-    writeNodes(javadoc->getBlocks());
+    writeNodes(jd.getBlocks());
     tags_.close(javadocTagName);
 }
 
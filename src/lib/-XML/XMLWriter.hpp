@@ -17,7 +17,9 @@
 #include <mrdox/Corpus.hpp>
 #include <mrdox/Metadata.hpp>
 #include <mrdox/Support/Error.hpp>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace clang {
 namespace mrdox {
@@ -47,6 +49,19 @@ protected:
     };
     Options options_;
 
+    // A symbol left out of the outline, to be
+    // written at `offset` with the given indent.
+    struct Member
+    {
+        Info const* I;
+        std::string indent;
+        std::uint64_t offset;
+    };
+
+    // When set, symbols other than namespaces
+    // are collected here instead of written.
+    std::vector<Member>* members_ = nullptr;
+
 public:
     XMLWriter(
         llvm::raw_ostream& os,
@@ -56,6 +71,20 @@ public:
 
     void writeIndex();
 
+    /** Write the symbols, starting at the global namespace.
+
+        The namespaces are written first as an
+        outline, leaving out their other members.
+        Those are written in parallel, a window at
+        a time, and placed in the outline in order,
+        so the output is the same as writing the
+        symbols on one thread, which is what is
+        done when the thread pool has one thread.
+    */
+    Error writeSymbols();
+
+    void writeMember(Member const& M, std::string& text);
+
     template<class T>
     void operator()(T const&);
 
@@ -15,8 +15,14 @@
 #include "lib/Support/Radix.hpp"
 #include <mrdox/Metadata/DomMetadata.hpp>
 #include <mrdox/Support/Error.hpp>
+#include <mrdox/Support/Handlebars.hpp>
 #include <mrdox/Support/JavaScript.hpp>
+#include <llvm/ADT/StringMap.h>
+#include <memory>
+#include <optional>
 #include <ostream>
+#include <string>
+#include <string_view>
 
 #include <mrdox/Dom.hpp>
 
@@ -34,12 +40,51 @@ class Builder
     DomCorpus const& domCorpus_;
     Corpus const& corpus_;
     Options options_;
-    js::Context ctx_;
+
+    // Exactly one engine is used
+    std::optional<js::Context> ctx_;
+    std::shared_ptr<Handlebars const> hbs_;
+
+    // The layouts used so far, each read once. The
+    // native engine renders from the text, while
+    // handlebars.js keeps the compiled layout and
+    // the text is left empty.
+    llvm::StringMap<std::string> layouts_;
+
+    void runScripts(std::string_view bytecode);
 
 public:
+    /** Return the bytecode which initializes each Builder.
+
+        The Handlebars library, the partials, and
+        the helpers are compiled once into bytecode,
+        which each Builder runs in its own context.
+    */
+    static
+    Expected<std::string>
+    compileScripts(
+        Corpus const& corpus);
+
+    /** Return the native engine used by each Builder.
+
+        The partials and helpers are registered once.
+        Rendering does not modify the engine, so every
+        Builder renders with the same instance.
+    */
+    static
+    Expected<std::shared_ptr<Handlebars const>>
+    makeHandlebars(
+        Corpus const& corpus);
+
+    Builder(
+        DomCorpus const& domCorpus,
+        Options const& options,
+        std::string_view bytecode);
+
     Builder(
         DomCorpus const& domCorpus,
-        Options const& options);
+        Options const& options,
+        std::shared_ptr<Handlebars const> hbs);
 
     dom::Value createContext(SymbolID const& id);
 
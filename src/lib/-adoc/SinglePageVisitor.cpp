@@ -10,17 +10,66 @@
 
 #include "SinglePageVisitor.hpp"
 #include <mrdox/Support/unlock_guard.hpp>
+#include <algorithm>
 
 namespace clang {
 namespace mrdox {
 namespace adoc {
 
+SinglePageVisitor::
+SinglePageVisitor(
+    ExecutorGroup<Builder>& ex,
+    Corpus const& corpus,
+    std::ostream& os)
+    : ex_(ex)
+    , corpus_(corpus)
+    , os_(os)
+    , ring_(std::max<std::size_t>(16,
+        4 * corpus.config.threadPool().getThreadCount()))
+    , writer_([this]{ writePages(); })
+{
+}
+
+SinglePageVisitor::
+~SinglePageVisitor()
+{
+    if(writer_.joinable())
+        finish();
+}
+
+void
+SinglePageVisitor::
+finish()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        lastPage_ = numPages_;
+        finished_ = true;
+    }
+    pageReady_.notify_one();
+    writer_.join();
+}
+
 template<class T>
 void
 SinglePageVisitor::
 operator()(T const& I)
 {
-    renderPage(I, numPages_++);
+    std::size_t const pageNumber = numPages_;
+    {
+        // wait until the page fits in the window
+        std::unique_lock<std::mutex> lock(mutex_);
+        pageWritten_.wait(lock,
+            [&]
+            {
+                return pageNumber < topPage_ + ring_.size();
+            });
+    }
+    renderPage(I, pageNumber);
+    // The page is counted once its task is posted, so
+    // that finish never waits for a page which failed
+    // to launch. The task always delivers its page.
+    ++numPages_;
     if constexpr(
             T::isNamespace() ||
             T::isRecord() ||
@@ -40,7 +89,19 @@ renderPage(
     ex_.async(
         [this, &I, pageNumber](Builder& builder)
         {
-            endPage(builder(I).value(), pageNumber);
+            // A page which fails is still delivered,
+            // so that the writer can move past it.
+            std::string pageText;
+            try
+            {
+                pageText = builder(I).value();
+            }
+            catch(...)
+            {
+                endPage({}, pageNumber);
+                throw;
+            }
+            endPage(std::move(pageText), pageNumber);
         });
 }
 
@@ -51,35 +112,44 @@ endPage(
     std::string pageText,
     std::size_t pageNumber)
 {
-    std::unique_lock<std::mutex> lock(mutex_);
-
-    if(pageNumber > topPage_)
     {
-        // defer this page
-        if( pages_.size() <= pageNumber)
-            pages_.resize(pageNumber + 1);
-        pages_[pageNumber] = std::move(pageText);
-        return;
+        std::lock_guard<std::mutex> lock(mutex_);
+        ++pendingPages_;
+        pendingBytes_ += pageText.size();
+        peakPages_ = std::max(peakPages_, pendingPages_);
+        peakBytes_ = std::max(peakBytes_, pendingBytes_);
+        ring_[pageNumber % ring_.size()] = std::move(pageText);
     }
+    pageReady_.notify_one();
+}
 
-    // write contiguous pages
+// Write the pages in order, as they arrive
+void
+SinglePageVisitor::
+writePages()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
     for(;;)
     {
+        auto& slot = ring_[topPage_ % ring_.size()];
+        pageReady_.wait(lock,
+            [&]
+            {
+                return slot.has_value() ||
+                    (finished_ && topPage_ == lastPage_);
+            });
+        if(! slot)
+            return;
+        std::string pageText = std::move(*slot);
+        slot.reset();
+        --pendingPages_;
+        pendingBytes_ -= pageText.size();
         {
             unlock_guard unlock(mutex_);
             os_.write(pageText.data(), pageText.size());
-            ++pageNumber;
         }
-        topPage_ = pageNumber;
-        if(pageNumber >= pages_.size())
-            return;
-        if(! pages_[pageNumber])
-            return;
-        pageText = std::move(*pages_[pageNumber]);
-        // VFALCO this is in theory not needed but
-        // I am paranoid about the std::move of the
-        // string not resulting in a deallocation.
-        pages_[pageNumber].reset();
+        ++topPage_;
+        pageWritten_.notify_one();
     }
 }
 
@@ -13,9 +13,12 @@
 
 #include "Builder.hpp"
 #include <mrdox/Support/ExecutorGroup.hpp>
+#include <condition_variable>
 #include <mutex>
+#include <optional>
 #include <ostream>
 #include <string>
+#include <thread>
 #include <vector>
 
 namespace clang {
@@ -23,33 +26,79 @@ namespace mrdox {
 namespace adoc {
 
 /** Visitor which writes everything to a single page.
+
+    Pages are rendered in parallel and written in
+    order by a dedicated thread. Rendered pages wait
+    in a window of fixed size, and the visitor stops
+    launching pages which would fall past the end of
+    the window, so memory use does not grow with the
+    number of pages.
 */
 class SinglePageVisitor
 {
     ExecutorGroup<Builder>& ex_;
     Corpus const& corpus_;
     std::ostream& os_;
-    std::size_t numPages_ = 0; 
+    std::size_t numPages_ = 0;
+
     std::mutex mutex_;
-    std::size_t topPage_ = 0;
+    std::condition_variable pageReady_;
+    std::condition_variable pageWritten_;
+    // page n is in ring_[n % ring_.size()]
     std::vector<std::optional<
-        std::string>> pages_;
+        std::string>> ring_;
+    std::size_t topPage_ = 0;
+    std::size_t lastPage_ = 0;
+    bool finished_ = false;
+
+    std::size_t pendingPages_ = 0;
+    std::size_t pendingBytes_ = 0;
+    std::size_t peakPages_ = 0;
+    std::size_t peakBytes_ = 0;
+
+    // Declared last, so that the thread starts after
+    // every member it uses has been initialized.
+    std::thread writer_;
 
 public:
     SinglePageVisitor(
         ExecutorGroup<Builder>& ex,
         Corpus const& corpus,
-        std::ostream& os) noexcept
-        : ex_(ex)
-        , corpus_(corpus)
-        , os_(os)
+        std::ostream& os);
+
+    ~SinglePageVisitor();
+
+    /** Write the remaining pages.
+
+        This must be called after every
+        page launched by the visitor has
+        been rendered.
+    */
+    void finish();
+
+    /** Return the largest number of pages which waited to be written.
+    */
+    std::size_t
+    peakPages() const noexcept
     {
+        return peakPages_;
+    }
+
+    /** Return the largest size of the pages which waited to be written.
+    */
+    std::size_t
+    peakBytes() const noexcept
+    {
+        return peakBytes_;
     }
 
     template<class T>
     void operator()(T const& I);
     void renderPage(auto const& I, std::size_t pageNumber);
     void endPage(std::string pageText, std::size_t pageNumber);
+
+private:
+    void writePages();
 };
 
 } // adoc
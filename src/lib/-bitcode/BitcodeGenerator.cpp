@@ -11,6 +11,7 @@
 
 #include "BitcodeGenerator.hpp"
 #include "lib/Support/Error.hpp"
+#include "lib/Support/OutputFiles.hpp"
 #include "lib/Support/SafeNames.hpp"
 #include "lib/AST/Bitcode.hpp"
 #include <mrdox/Support/ThreadPool.hpp>
@@ -23,7 +24,7 @@ namespace bitcode {
 class MultiFileBuilder
 {
     Corpus const& corpus_;
-    std::string_view outputPath_;
+    OutputFiles output_;
     SafeNames names_;
     TaskGroup taskGroup_;
 
@@ -32,7 +33,7 @@ public:
         std::string_view outputPath,
         Corpus const& corpus)
         : corpus_(corpus)
-        , outputPath_(outputPath)
+        , output_(outputPath, "bc", corpus.config)
         , names_(corpus_)
         , taskGroup_(corpus.config.threadPool())
     {
@@ -46,32 +47,20 @@ public:
         auto errors = taskGroup_.wait();
         if(! errors.empty())
             return Error(errors);
-        return Error::success();
+        return output_.finish();
     }
 
     template<class T>
     void operator()(T const& I)
     {
-        namespace fs = llvm::sys::fs;
-        namespace path = llvm::sys::path;
-
         taskGroup_.async(
             [&]
             {
-                llvm::SmallString<512> filePath(outputPath_);
-                llvm::StringRef name = names_.get(I.id);
-                path::append(filePath, name);
-                filePath.append(".bc");
-                std::error_code ec;
-                llvm::raw_fd_ostream os(filePath, ec, fs::CD_CreateAlways);
-                if(ec)
-                    Error(ec).Throw();
                 auto bc = writeBitcode(I);
-                if((ec = os.error()))
-                    Error(ec).Throw();
-                os.write(bc.data.data(), bc.data.size());
-                if((ec = os.error()))
-                    Error(ec).Throw();
+                output_.write(
+                    (names_.get(I.id) + ".bc").str(),
+                    std::string(bc.data.data(), bc.data.size())
+                        ).maybeThrow();
             });
 
         if constexpr(T::isRecord())
@@ -118,6 +118,7 @@ class ASTVisitor
 public:
     const ConfigImpl& config_;
     Diagnostics diags_;
+    JavadocCache& javadocs_;
 
     CompilerInstance& compiler_;
     ASTContext& context_;
@@ -150,11 +151,13 @@ public:
     ASTVisitor(
         const ConfigImpl& config,
         Diagnostics& diags,
+        JavadocCache& javadocs,
         CompilerInstance& compiler,
         ASTContext& context,
         Sema& sema) noexcept
         : config_(config)
         , diags_(diags)
+        , javadocs_(javadocs)
         , compiler_(compiler)
         , context_(context)
         , source_(context.getSourceManager())
@@ -1334,7 +1337,10 @@ public:
         // ASTContext::getCommentForDecl instead
         RawComment* RC =
             D->getASTContext().getRawCommentForDeclNoCache(D);
-        parseJavadoc(javadoc, RC, D, config_, diags_);
+        if(config_->lazyJavadoc)
+            storeJavadoc(javadoc, RC, D, config_, diags_, javadocs_);
+        else
+            parseJavadoc(javadoc, RC, D, config_, diags_, javadocs_);
     }
 
     //------------------------------------------------
@@ -2660,6 +2666,7 @@ class ASTVisitorConsumer
 {
     const ConfigImpl& config_;
     ExecutionContext& ex_;
+    JavadocCache& javadocs_;
     CompilerInstance& compiler_;
 
     Sema* sema_ = nullptr;
@@ -2705,6 +2712,7 @@ class ASTVisitorConsumer
         ASTVisitor visitor(
             config_,
             diags,
+            javadocs_,
             compiler_,
             Context,
             *sema_);
@@ -2785,9 +2793,11 @@ public:
     ASTVisitorConsumer(
         const ConfigImpl& config,
         tooling::ExecutionContext& ex,
+        JavadocCache& javadocs,
         CompilerInstance& compiler) noexcept
         : config_(config)
         , ex_(static_cast<ExecutionContext&>(ex))
+        , javadocs_(javadocs)
         , compiler_(compiler)
     {
     }
@@ -2804,9 +2814,11 @@ struct ASTAction
 {
     ASTAction(
         tooling::ExecutionContext& ex,
-        ConfigImpl const& config) noexcept
+        ConfigImpl const& config,
+        JavadocCache& javadocs) noexcept
         : ex_(ex)
         , config_(config)
+        , javadocs_(javadocs)
     {
     }
 
@@ -2832,12 +2844,13 @@ struct ASTAction
         llvm::StringRef InFile) override
     {
         return std::make_unique<ASTVisitorConsumer>(
-            config_, ex_, Compiler);
+            config_, ex_, javadocs_, Compiler);
     }
 
 private:
     tooling::ExecutionContext& ex_;
     ConfigImpl const& config_;
+    JavadocCache& javadocs_;
 };
 
 //------------------------------------------------
@@ -2856,12 +2869,17 @@ struct ASTActionFactory :
     std::unique_ptr<FrontendAction>
     create() override
     {
-        return std::make_unique<ASTAction>(ex_, config_);
+        return std::make_unique<ASTAction>(
+            ex_, config_, javadocs_);
     }
 
 private:
     tooling::ExecutionContext& ex_;
     ConfigImpl const& config_;
+
+    // Comments parsed during this run, shared
+    // by every translation unit.
+    JavadocCache javadocs_;
 };
 
 } // (anon)
@@ -15,8 +15,10 @@
 
 #include "BitcodeReader.hpp"
 #include "DecodeRecord.hpp"
+#include "ParseJavadoc.hpp"
 #include "lib/Support/Debug.hpp"
 #include "lib/Support/Error.hpp"
+#include <llvm/Support/xxhash.h>
 
 namespace clang {
 namespace mrdox {
@@ -79,14 +81,16 @@ class JavadocNodesBlock
     : public BitcodeReader::AnyBlock
 {
     BitcodeReader& br_;
+    doc::Arena& arena_;
 
 public:
     doc::List<doc::Node> nodes;
 
-    explicit
     JavadocNodesBlock(
+        doc::Arena& arena,
         BitcodeReader& br) noexcept
         : br_(br)
+        , arena_(arena)
     {
     }
 
@@ -147,7 +151,7 @@ public:
                 {
                     if constexpr(! std::is_same_v<T, void>)
                     {
-                        nodes.emplace_back(std::make_unique<T>());
+                        nodes.emplace_back(arena_.create<T>());
                         return Error::success();
                     }
                     else
@@ -216,7 +220,7 @@ public:
                 node->kind == doc::Kind::styled)
                 return formatError("text node cannot have list");
 
-            JavadocNodesBlock B(br_);
+            JavadocNodesBlock B(arena_, br_);
             if(auto err = br_.readBlock(B, ID))
                 return err;
             static_cast<doc::Block*>(node)->append(
@@ -242,6 +246,8 @@ class JavadocBlock
 {
     BitcodeReader& br_;
     std::unique_ptr<Javadoc>& I_;
+    std::uint64_t hash_ = 0;
+    std::vector<std::string> blockCommands_;
 
 public:
     JavadocBlock(
@@ -253,6 +259,52 @@ public:
         I_ = std::make_unique<Javadoc>();
     }
 
+    Error
+    parseRecord(
+        Record const& R,
+        unsigned ID,
+        llvm::StringRef Blob) override
+    {
+        switch(ID)
+        {
+        case JAVADOC_HASH:
+        {
+            std::uint64_t hash = 0;
+            if(auto err = decodeRecord(R, hash, Blob))
+                return err;
+            I_->setHash(hash);
+            return Error::success();
+        }
+        case JAVADOC_RAW_HASH:
+            return decodeRecord(R, hash_, Blob);
+        case JAVADOC_RAW_COMMAND:
+        {
+            std::string name;
+            if(auto err = decodeRecord(R, name, Blob))
+                return err;
+            blockCommands_.emplace_back(std::move(name));
+            return Error::success();
+        }
+        case JAVADOC_RAW_TEXT:
+        {
+            std::string text;
+            if(auto err = decodeRecord(R, text, Blob))
+                return err;
+            // a zero hash is elided by the writer
+            if(hash_ == 0)
+                hash_ = llvm::xxHash64(text);
+            I_->appendRaw(doc::RawText{
+                std::move(text), hash_,
+                std::move(blockCommands_) }, &parseJavadoc);
+            hash_ = 0;
+            blockCommands_.clear();
+            return Error::success();
+        }
+        default:
+            return AnyBlock::parseRecord(R, ID, Blob);
+        }
+    }
+
     Error
     readSubBlock(
         unsigned ID) override
@@ -261,7 +313,7 @@ public:
         {
         case BI_JAVADOC_LIST_BLOCK_ID:
         {
-            JavadocNodesBlock B(br_);
+            JavadocNodesBlock B(I_->arena(), br_);
             if(auto err = br_.readBlock(B, ID))
                 return err;
             I_->append(std::move(B.nodes));
@@ -77,6 +77,18 @@ Bitcode
 writeBitcode(
     Info const& I);
 
+/** Return bitcode which depends only on the content of a symbol.
+
+    Line numbers are omitted, and javadocs are
+    written parsed even when they were stored
+    without parsing. Symbols whose content is the
+    same have the same content bitcode. Pending
+    comments of the symbol are parsed.
+*/
+Bitcode
+writeContentBitcode(
+    Info const& I);
+
 /** Return an array of Info read from a bitstream.
 */
 mrdox::Expected<std::vector<std::unique_ptr<Info>>>
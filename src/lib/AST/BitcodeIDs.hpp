@@ -22,7 +22,7 @@ namespace mrdox {
 // Current version number of clang-doc bitcode.
 // Should be bumped when removing or changing BlockIds, RecordIDs, or
 // BitCodeConstants, though they can be added without breaking it.
-static const unsigned BitcodeVersion = 3;
+static const unsigned BitcodeVersion = 6;
 
 struct BitCodeConstants
 {
@@ -117,6 +117,10 @@ enum RecordID
     JAVADOC_NODE_STRING,
     JAVADOC_NODE_STYLE,
     JAVADOC_PARAM_DIRECTION,
+    JAVADOC_HASH,
+    JAVADOC_RAW_HASH,
+    JAVADOC_RAW_COMMAND,
+    JAVADOC_RAW_TEXT,
     ENUM_SCOPED,
     ENUM_VALUE_NAME,
     ENUM_VALUE_VALUE,
@@ -276,6 +276,10 @@ RecordIDNameMap = []()
         {JAVADOC_NODE_STRING, {"JavadocNodeString", &StringAbbrev}},
         {JAVADOC_NODE_STYLE, {"JavadocNodeStyle", &Integer32Abbrev}},
         {JAVADOC_PARAM_DIRECTION, {"JavadocParamDirection", &Integer32Abbrev}},
+        {JAVADOC_HASH, {"JavadocHash", &Integer64Abbrev}},
+        {JAVADOC_RAW_HASH, {"JavadocRawHash", &Integer64Abbrev}},
+        {JAVADOC_RAW_COMMAND, {"JavadocRawCommand", &StringAbbrev}},
+        {JAVADOC_RAW_TEXT, {"JavadocRawText", &StringAbbrev}},
         {NAMESPACE_MEMBERS, {"NamespaceMembers", &SymbolIDsAbbrev}},
         {NAMESPACE_SPECIALIZATIONS, {"NamespaceSpecializations", &SymbolIDsAbbrev}},
         {NAMESPACE_BITS, {"NamespaceBits", &Integer32ArrayAbbrev}},
@@ -355,7 +359,8 @@ RecordsByBlock{
         {FUNCTION_PARAM_NAME, FUNCTION_PARAM_DEFAULT}},
     // Javadoc
     {BI_JAVADOC_BLOCK_ID,
-        {}},
+        {JAVADOC_HASH, JAVADOC_RAW_HASH,
+            JAVADOC_RAW_COMMAND, JAVADOC_RAW_TEXT}},
     // doc::List<doc::Node>
     {BI_JAVADOC_LIST_BLOCK_ID,
         {}},
@@ -405,8 +410,10 @@ RecordsByBlock{
 
 BitcodeWriter::
 BitcodeWriter(
-    llvm::BitstreamWriter &Stream)
+    llvm::BitstreamWriter &Stream,
+    bool contentOnly)
     : Stream(Stream)
+    , contentOnly_(contentOnly)
 {
     emitHeader();
     emitBlockInfoBlock();
@@ -681,7 +688,7 @@ emitRecord(
         return;
     // FIXME: Assert that the line number
     // is of the appropriate size.
-    Record.push_back(Loc.LineNumber);
+    Record.push_back(contentOnly_ ? 0 : Loc.LineNumber);
     MRDOX_ASSERT(Loc.Filename.size() < (1U << BitCodeConstants::StringLengthSize));
     Record.push_back(Loc.IsFileInRootDir);
     Record.push_back(Loc.Filename.size());
@@ -865,7 +872,26 @@ emitBlock(
     // If the unique_ptr<Javadoc> has a value then we
     // always want to emit it, even if it is empty.
     StreamSubBlockGuard Block(Stream, BI_JAVADOC_BLOCK_ID);
-    emitBlock(jd->getBlocks());
+    // The same comments must encode the same
+    // whether or not they were parsed lazily.
+    if(contentOnly_)
+    {
+        Javadoc const& cjd = *jd;
+        emitBlock(cjd.getBlocks());
+        return;
+    }
+    emitRecord(jd->hash(), JAVADOC_HASH);
+    // Comments stored without parsing are
+    // written as text, followed by any which
+    // were parsed. This does not parse them.
+    for(auto const& raw : jd->getPending())
+    {
+        emitRecord(raw.hash, JAVADOC_RAW_HASH);
+        for(auto const& name : raw.blockCommands)
+            emitRecord(name, JAVADOC_RAW_COMMAND);
+        emitRecord(raw.text, JAVADOC_RAW_TEXT);
+    }
+    emitBlock(jd->getParsedBlocks());
 }
 
 void
@@ -1153,5 +1179,16 @@ writeBitcode(
     return Bitcode{ I.id, std::move(Buffer) };
 }
 
+Bitcode
+writeContentBitcode(
+    Info const& I)
+{
+    SmallString<0> Buffer;
+    llvm::BitstreamWriter Stream(Buffer);
+    BitcodeWriter writer(Stream, true);
+    writer.dispatchInfoForWrite(&I);
+    return Bitcode{ I.id, std::move(Buffer) };
+}
+
 } // mrdox
 } // clang
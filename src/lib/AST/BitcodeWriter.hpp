@@ -47,8 +47,17 @@ public:
     using RecordType = SmallVector<
         RecordValue, BitCodeConstants::RecordSize>;
 
+    /** Constructor.
+
+        @param contentOnly If `true`, line numbers
+        are written as zero and javadocs are always
+        written parsed, so the output depends only
+        on the content of the symbol.
+    */
     explicit
-    BitcodeWriter(llvm::BitstreamWriter &Stream);
+    BitcodeWriter(
+        llvm::BitstreamWriter &Stream,
+        bool contentOnly = false);
 
     // Write a specific info to a bitcode stream.
     bool dispatchInfoForWrite(Info const* I);
@@ -180,6 +189,7 @@ private:
     RecordType Record;
     llvm::BitstreamWriter& Stream;
     AbbreviationMap Abbrevs;
+    bool contentOnly_;
 };
 
 } // mrdox
@@ -10,6 +10,7 @@
 //
 
 #include "ParseJavadoc.hpp"
+#include "BitcodeIDs.hpp"
 #include <mrdox/Metadata/Javadoc.hpp>
 #include <mrdox/Support/Error.hpp>
 #include <mrdox/Support/Path.hpp>
@@ -26,8 +27,16 @@
 #ifdef _MSC_VER
 #pragma warning(pop)
 #endif
+#include <clang/AST/CommentLexer.h>
+#include <clang/AST/CommentParser.h>
+#include <clang/AST/CommentSema.h>
+#include <clang/Basic/Diagnostic.h>
+#include <clang/Basic/FileManager.h>
 #include <clang/Basic/SourceManager.h>
 #include <llvm/Support/JSON.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/xxhash.h>
+#include <mutex>
 
 /*  AST Types
 
@@ -100,8 +109,7 @@ using namespace comments;
 class JavadocVisitor
     : public ConstCommentVisitor<JavadocVisitor>
 {
-    Config const& config_;
-    ASTContext const& ctx_;
+    CommandTraits const& traits_;
     SourceManager const& sm_;
     FullComment const* FC_;
     Javadoc jd_;
@@ -117,8 +125,8 @@ class JavadocVisitor
 
 public:
     JavadocVisitor(
-        RawComment const*, Decl const*,
-        Config const&, Diagnostics&);
+        FullComment const*, CommandTraits const&,
+        SourceManager const&, Diagnostics&);
     Javadoc build();
 
     void visitComment(Comment const* C);
@@ -203,14 +211,13 @@ visitChildren(
 
 JavadocVisitor::
 JavadocVisitor(
-    RawComment const* RC,
-    Decl const* D,
-    Config const& config,
+    FullComment const* FC,
+    CommandTraits const& traits,
+    SourceManager const& sm,
     Diagnostics& diags)
-    : config_(config)
-    , ctx_(D->getASTContext())
-    , sm_(ctx_.getSourceManager())
-    , FC_(RC->parse(D->getASTContext(), nullptr, D))
+    : traits_(traits)
+    , sm_(sm)
+    , FC_(FC)
     , diags_(diags)
 {
 }
@@ -254,7 +261,8 @@ visitTextComment(
 
     // Only insert non-empty text nodes
     if(! s.empty())
-        block_->emplace_back(doc::Text(ensureUTF8(s.str())));
+        block_->emplace_back(jd_.arena(),
+            doc::Text(ensureUTF8(s.str())));
 }
 
 void
@@ -308,9 +316,10 @@ visitHTMLStartTagComment(
                 break;
             }
         }
-        block_->emplace_back(doc::Link(
-            ensureUTF8(std::move(text)),
-            ensureUTF8(std::move(href))));
+        block_->emplace_back(jd_.arena(),
+            doc::Link(
+                ensureUTF8(std::move(text)),
+                ensureUTF8(std::move(href))));
 
         it_ += 2; // bit of a hack
     }
@@ -331,8 +340,7 @@ JavadocVisitor::
 visitInlineCommandComment(
     InlineCommandComment const* C)
 {
-    auto const* cmd = ctx_
-        .getCommentCommandTraits()
+    auto const* cmd = traits_
         .getCommandInfo(C->getCommandID());
 
     // VFALCO I'd like to know when this happens
@@ -349,7 +357,8 @@ visitInlineCommandComment(
             return;
         auto style = doc::Style::italic;
         auto s = C->getArgText(0);
-        block_->emplace_back(doc::Styled(s.str(), style));
+        block_->emplace_back(jd_.arena(),
+            doc::Styled(s.str(), style));
         return;
     }
 
@@ -404,9 +413,11 @@ visitInlineCommandComment(
         s.append(C->getArgText(i));
 
     if(style != doc::Style::none)
-        block_->emplace_back(doc::Styled(std::move(s), style));
+        block_->emplace_back(jd_.arena(),
+            doc::Styled(std::move(s), style));
     else
-        block_->emplace_back(doc::Text(std::move(s)));
+        block_->emplace_back(jd_.arena(),
+            doc::Text(std::move(s)));
 }
 
 //------------------------------------------------
@@ -435,8 +446,7 @@ JavadocVisitor::
 visitBlockCommandComment(
     BlockCommandComment const* C)
 {
-    auto const* cmd = ctx_
-        .getCommentCommandTraits()
+    auto const* cmd = traits_
         .getCommandInfo(C->getCommandID());
     if(cmd == nullptr)
     {
@@ -823,7 +833,8 @@ JavadocVisitor::
 visitVerbatimBlockLineComment(
     VerbatimBlockLineComment const* C)
 {
-    block_->emplace_back(doc::Text(C->getText().str()));
+    block_->emplace_back(jd_.arena(),
+        doc::Text(C->getText().str()));
 }
 
 //------------------------------------------------
@@ -852,8 +863,63 @@ goodArgCount(std::size_t n,
 
 //------------------------------------------------
 
+// Return the cache key for a comment, which
+// includes the options that change the parse.
+std::uint64_t
+cacheKey(
+    std::uint64_t hash,
+    std::vector<std::string> const& blockCommands)
+{
+    std::string s;
+    for(auto const& name : blockCommands)
+    {
+        s.append(name);
+        s.push_back('\0');
+    }
+    return hash ^ (llvm::xxHash64(s) + 0x9e3779b97f4a7c15ULL +
+        (hash << 6) + (hash >> 2));
+}
+
 } // (anon)
 
+//------------------------------------------------
+
+JavadocCache::
+JavadocCache(
+    std::size_t maxBytes) noexcept
+    : maxBytes_(maxBytes)
+{
+}
+
+std::shared_ptr<Javadoc const>
+JavadocCache::
+find(
+    std::uint64_t key,
+    llvm::StringRef text)
+{
+    std::shared_lock<std::shared_mutex> lock(mutex_);
+    auto it = map_.find(key);
+    if(it == map_.end() || it->second.text != text)
+        return nullptr;
+    return it->second.jd;
+}
+
+void
+JavadocCache::
+insert(
+    std::uint64_t key,
+    llvm::StringRef text,
+    std::shared_ptr<Javadoc const> jd)
+{
+    std::lock_guard<std::shared_mutex> lock(mutex_);
+    if(bytes_ + text.size() > maxBytes_)
+        return;
+    if(map_.try_emplace(key, Entry{ text.str(), std::move(jd) }).second)
+        bytes_ += text.size();
+}
+
+//------------------------------------------------
+
 void
 initCustomCommentCommands(ASTContext& context)
 {
@@ -877,12 +943,30 @@ parseJavadoc(
     RawComment* RC,
     Decl const* D,
     Config const& config,
-    Diagnostics& diags)
+    Diagnostics& diags,
+    JavadocCache& cache)
 {
     if(! RC)
         return;
     RC->setAttached();
-    auto result = JavadocVisitor(RC, D, config, diags).build();
+    auto const& ctx = D->getASTContext();
+    auto const text = RC->getRawText(ctx.getSourceManager());
+    auto const hash = llvm::xxHash64(text);
+    auto const key = cacheKey(hash,
+        ctx.getLangOpts().CommentOpts.BlockCommandNames);
+    auto shared = cache.find(key, text);
+    if(! shared)
+    {
+        auto parsed = JavadocVisitor(
+            RC->parse(ctx, nullptr, D),
+            ctx.getCommentCommandTraits(),
+            ctx.getSourceManager(),
+            diags).build();
+        parsed.setHash(key);
+        shared = std::make_shared<Javadoc const>(std::move(parsed));
+        cache.insert(key, text, shared);
+    }
+    Javadoc result(std::move(shared));
     if(jd == nullptr)
     {
         // Do not create javadocs which have no nodes
@@ -896,5 +980,79 @@ parseJavadoc(
     }
 }
 
+void
+storeJavadoc(
+    std::unique_ptr<Javadoc>& jd,
+    RawComment* RC,
+    Decl const* D,
+    Config const& config,
+    Diagnostics& diags,
+    JavadocCache& cache)
+{
+    if(! RC)
+        return;
+    auto const& ctx = D->getASTContext();
+    auto text = RC->getRawText(ctx.getSourceManager());
+    // The bitcode cannot hold longer strings
+    if(text.size() >= (1U << BitCodeConstants::StringLengthSize))
+        return parseJavadoc(jd, RC, D, config, diags, cache);
+    RC->setAttached();
+    if(jd == nullptr)
+        jd = std::make_unique<Javadoc>();
+    // The comment is parsed later with
+    // the options of this translation unit
+    jd->appendRaw(doc::RawText{
+        text.str(),
+        llvm::xxHash64(text),
+        ctx.getLangOpts().CommentOpts.BlockCommandNames },
+        &parseJavadoc);
+}
+
+Javadoc
+parseJavadoc(
+    doc::RawText const& text)
+{
+    llvm::StringRef const raw(text.text);
+    auto const key = cacheKey(
+        llvm::xxHash64(raw), text.blockCommands);
+    CommentOptions opts;
+    opts.BlockCommandNames = text.blockCommands;
+
+    // The comment parser needs a source manager
+    // and diagnostics engine, even though there
+    // is no translation unit at this point.
+    DiagnosticsEngine engine(
+        new DiagnosticIDs,
+        new DiagnosticOptions,
+        new IgnoringDiagConsumer);
+    FileSystemOptions fsOpts;
+    llvm::IntrusiveRefCntPtr<FileManager> fm(
+        new FileManager(fsOpts));
+    SourceManager sm(engine, *fm);
+    engine.setSourceManager(&sm);
+    FileID fid = sm.createFileID(
+        llvm::MemoryBuffer::getMemBuffer(
+            raw, "<javadoc>", false));
+    SourceLocation loc = sm.getLocForStartOfFile(fid);
+    auto buffer = sm.getBufferData(fid);
+
+    llvm::BumpPtrAllocator allocator;
+    comments::CommandTraits traits(
+        allocator, opts);
+    comments::Lexer lexer(allocator, engine,
+        traits, loc, buffer.begin(), buffer.end());
+    comments::Sema sema(allocator, sm,
+        engine, traits, nullptr);
+    comments::Parser parser(lexer, sema,
+        allocator, sm, engine, traits);
+    Diagnostics diags;
+    auto result = JavadocVisitor(
+        parser.parseFullComment(),
+        traits, sm, diags).build();
+    result.setHash(key);
+    Diagnostics().mergeAndReport(std::move(diags));
+    return result;
+}
+
 } // mrdox
 } // clang
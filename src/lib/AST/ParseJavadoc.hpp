@@ -16,6 +16,14 @@
 #include <mrdox/Platform.hpp>
 #include <mrdox/Config.hpp>
 #include <mrdox/Metadata/Javadoc.hpp>
+#include <llvm/ADT/StringRef.h>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <shared_mutex>
+#include <string>
+#include <string_view>
+#include <unordered_map>
 
 namespace clang {
 
@@ -34,6 +42,59 @@ void
 initCustomCommentCommands(
     ASTContext& ctx);
 
+/** A cache of parsed javadocs for one extraction run.
+
+    The same comment in a header is seen once
+    for every translation unit which includes
+    it. Entries are keyed by a hash of the text
+    and of the options which affect the parse,
+    and the text is compared to rule out
+    collisions. Cached javadocs are immutable
+    and shared; a javadoc made from one only
+    copies the nodes if it is changed.
+
+    The cache is owned by the frontend action
+    factory, so it is released when extraction
+    ends. Once the cached comments reach
+    `maxBytes` of text, further comments are
+    parsed but not cached.
+*/
+class JavadocCache
+{
+    struct Entry
+    {
+        std::string text;
+        std::shared_ptr<Javadoc const> jd;
+    };
+
+    std::shared_mutex mutex_;
+    std::unordered_map<std::uint64_t, Entry> map_;
+    std::size_t bytes_ = 0;
+    std::size_t maxBytes_;
+
+public:
+    explicit
+    JavadocCache(
+        std::size_t maxBytes = 64 * 1024 * 1024) noexcept;
+
+    /** Return the cached javadoc, or nullptr if there is none.
+    */
+    std::shared_ptr<Javadoc const>
+    find(
+        std::uint64_t key,
+        llvm::StringRef text);
+
+    /** Insert a parsed javadoc.
+
+        @param jd A javadoc with no pending comments.
+    */
+    void
+    insert(
+        std::uint64_t key,
+        llvm::StringRef text,
+        std::shared_ptr<Javadoc const> jd);
+};
+
 /** Parse a javadoc.
 */
 void
@@ -42,7 +103,44 @@ parseJavadoc(
     RawComment* RC,
     Decl const* D,
     Config const& config,
-    Diagnostics& diags);
+    Diagnostics& diags,
+    JavadocCache& cache);
+
+/** Store a javadoc without parsing it.
+
+    The text of the comment is appended to the
+    javadoc, which parses it on first access.
+    Comments too long to be stored in the
+    bitcode are parsed immediately.
+*/
+void
+storeJavadoc(
+    std::unique_ptr<Javadoc>& jd,
+    RawComment* RC,
+    Decl const* D,
+    Config const& config,
+    Diagnostics& diags,
+    JavadocCache& cache);
+
+/** Parse the text of a comment.
+
+    This is the @ref Javadoc::Parser for comments
+    which were stored without parsing during
+    extraction. The comment is parsed with the
+    block commands of the translation unit it
+    was read from. Since the declaration is not
+    available, parameter names are not checked
+    against it; the nodes only hold the names
+    as written, so this affects diagnostics
+    and not the result. Diagnostics are
+    reported when the parse completes.
+
+    @param text The comment, including
+    the comment markers.
+*/
+Javadoc
+parseJavadoc(
+    doc::RawText const& text);
 
 } // mrdox
 } // clang
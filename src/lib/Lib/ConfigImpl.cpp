@@ -12,6 +12,7 @@
 #include "lib/Lib/ConfigImpl.hpp"
 #include "lib/Support/Debug.hpp"
 #include "lib/Support/Error.hpp"
+#include "lib/Support/OutputFiles.hpp"
 #include "lib/Support/Path.hpp"
 #include "lib/Support/Yaml.hpp"
 #include <mrdox/Support/Path.hpp>
@@ -46,10 +47,14 @@ struct llvm::yaml::MappingTraits<
     static void mapping(IO& io,
         clang::mrdox::ConfigImpl::SettingsImpl& cfg)
     {
+        io.mapOptional("archive",           cfg.archive);
         io.mapOptional("defines",           cfg.defines);
+        io.mapOptional("fsync",             cfg.fsync);
+        io.mapOptional("generate",          cfg.generate);
         io.mapOptional("ignore-failures",   cfg.ignoreFailures);
         io.mapOptional("include-anonymous", cfg.includeAnonymous);
         io.mapOptional("include-private",   cfg.includePrivate);
+        io.mapOptional("lazy-javadoc",      cfg.lazyJavadoc);
         io.mapOptional("multipage",         cfg.multiPage);
         io.mapOptional("source-root",       cfg.sourceRoot);
 
@@ -109,6 +114,9 @@ ConfigImpl(
         Error(yin.error()).maybeThrow();
     }
 
+    if(auto policy = parseFsyncPolicy(settings_.fsync); ! policy)
+        policy.error().Throw();
+
     // This has to be forward slash style
     settings_.sourceRoot = files::makePosixStyle(files::makeDirsy(
         files::makeAbsolute(settings_.sourceRoot, settings_.workingDir)));
@@ -40,6 +40,14 @@ public:
         std::vector<std::string> defines;
 
         /** The list of formats to generate
+
+            This is used when no format is given
+            on the command line. All of the formats
+            are generated from a single extraction.
+
+            @code
+            generate: [ adoc, html, xml ]
+            @endcode
         */
         std::vector<std::string> generate;
 
@@ -51,6 +59,18 @@ public:
         */
         bool ignoreFailures = false;
 
+        /** `true` if javadocs should be parsed when first used.
+
+            The text of each comment is stored during
+            extraction and parsed only for symbols
+            which are rendered.
+
+            @code
+            lazy-javadoc: true
+            @endcode
+        */
+        bool lazyJavadoc = false;
+
         /** The full path to the source root directory.
 
             The returned path will always be POSIX
@@ -13,6 +13,9 @@
 #include <mrdox/Corpus.hpp>
 #include <mrdox/Metadata.hpp>
 #include <mrdox/Support/Error.hpp>
+#include <llvm/ADT/StringRef.h>
+#include <algorithm>
+#include <utility>
 
 namespace clang {
 namespace mrdox {
@@ -36,6 +39,103 @@ globalNamespace() const noexcept
     return get<NamespaceInfo>(SymbolID::zero);
 }
 
+std::vector<Info const*>
+Corpus::
+findByName(
+    std::string_view name,
+    bool ignoreCase) const
+{
+    std::vector<Info const*> result;
+    std::string temp;
+    for(Info const* I : index())
+    {
+        llvm::StringRef s = getFullyQualifiedName(*I, temp);
+        if(ignoreCase ?
+            s.equals_insensitive(name) :
+            s == llvm::StringRef(name))
+            result.push_back(I);
+    }
+    return result;
+}
+
+std::vector<Info const*>
+Corpus::
+findByPrefix(
+    std::string_view prefix,
+    bool ignoreCase,
+    std::size_t limit) const
+{
+    std::vector<std::pair<std::string, Info const*>> found;
+    std::string temp;
+    for(Info const* I : index())
+    {
+        llvm::StringRef s = getFullyQualifiedName(*I, temp);
+        if(ignoreCase ?
+            s.startswith_insensitive(prefix) :
+            s.startswith(prefix))
+            found.emplace_back(temp, I);
+    }
+    // Sorted without regard to case, as by the
+    // name index. The index is in order of ID, so
+    // symbols with the same name stay in that order.
+    std::stable_sort(found.begin(), found.end(),
+        [](auto const& e0, auto const& e1)
+        {
+            return llvm::StringRef(e0.first).compare_insensitive(
+                e1.first) < 0;
+        });
+    std::vector<Info const*> result;
+    result.reserve(std::min(found.size(), limit));
+    for(auto const& e : found)
+    {
+        if(result.size() >= limit)
+            break;
+        result.push_back(e.second);
+    }
+    return result;
+}
+
+Interface const*
+Corpus::
+findInterface(
+    RecordInfo const&) const noexcept
+{
+    return nullptr;
+}
+
+NamespaceOverloads const*
+Corpus::
+findOverloads(
+    NamespaceInfo const&) const noexcept
+{
+    return nullptr;
+}
+
+std::span<Info const* const>
+Corpus::
+findXRefs(
+    Info const&,
+    XRefKind) const noexcept
+{
+    return {};
+}
+
+std::string_view
+Corpus::
+getSafeName(
+    SymbolID const&) const noexcept
+{
+    return {};
+}
+
+std::string_view
+Corpus::
+qualifiedName(
+    Info const&) const noexcept
+{
+    return {};
+}
+
 //------------------------------------------------
 //
 // Modifiers
@@ -49,6 +149,15 @@ getFullyQualifiedName(
     const Info& I,
     std::string& temp) const
 {
+    // Use the name computed when the corpus
+    // was built, if there is one.
+    auto name = qualifiedName(I);
+    if(! name.empty())
+    {
+        temp.assign(name.data(), name.size());
+        return temp;
+    }
+
     temp.clear();
     for(auto const& ns_id : llvm::reverse(I.Namespace))
     {
@@ -0,0 +1,139 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#include "lib/Lib/CorpusDiff.hpp"
+#include "lib/-XML/XMLTags.hpp"
+#include "lib/Support/Debug.hpp"
+#include "lib/Support/Radix.hpp"
+#include <llvm/Support/JSON.h>
+
+namespace clang {
+namespace mrdox {
+
+Expected<CorpusDiff>
+diffCorpus(
+    CorpusImpl const& before,
+    CorpusImpl const& after)
+{
+    CorpusDiff diff;
+    // index() is only public on Corpus
+    auto const& index0 = static_cast<Corpus const&>(before).index();
+    auto const& index1 = static_cast<Corpus const&>(after).index();
+    auto const& hashes0 = before.contentHashes();
+    auto const& hashes1 = after.contentHashes();
+    MRDOX_ASSERT(hashes0.size() == index0.size());
+    MRDOX_ASSERT(hashes1.size() == index1.size());
+    std::size_t i = 0;
+    std::size_t j = 0;
+    while(i < index0.size() && j < index1.size())
+    {
+        Info const* I0 = index0[i];
+        Info const* I1 = index1[j];
+        if(I0->id < I1->id)
+        {
+            diff.removed.push_back(I0);
+            ++i;
+        }
+        else if(I1->id < I0->id)
+        {
+            diff.added.push_back(I1);
+            ++j;
+        }
+        else
+        {
+            // Symbols in both corpora are compared by
+            // the hashes of their content, which do not
+            // depend on line numbers or on whether the
+            // javadocs were parsed lazily.
+            if(hashes0[i] != hashes1[j])
+                diff.changed.emplace_back(I0, I1);
+            ++i;
+            ++j;
+        }
+    }
+    for(; i < index0.size(); ++i)
+        diff.removed.push_back(index0[i]);
+    for(; j < index1.size(); ++j)
+        diff.added.push_back(index1[j]);
+    return diff;
+}
+
+//------------------------------------------------
+
+void
+writeDiffJSON(
+    llvm::raw_ostream& os,
+    CorpusDiff const& diff,
+    Corpus const& before,
+    Corpus const& after)
+{
+    std::string temp;
+    llvm::json::OStream J(os, 2);
+    auto writeSymbol = [&](Info const& I, Corpus const& corpus)
+    {
+        J.object([&]
+        {
+            J.attribute("id", toBase16(I.id));
+            J.attribute("kind", toString(I.Kind).str());
+            J.attribute("name", corpus.getFullyQualifiedName(I, temp));
+        });
+    };
+    J.object([&]
+    {
+        J.attributeArray("added", [&]
+        {
+            for(Info const* I : diff.added)
+                writeSymbol(*I, after);
+        });
+        J.attributeArray("removed", [&]
+        {
+            for(Info const* I : diff.removed)
+                writeSymbol(*I, before);
+        });
+        J.attributeArray("changed", [&]
+        {
+            for(auto const& [I0, I1] : diff.changed)
+                writeSymbol(*I1, after);
+        });
+    });
+    os << '\n';
+}
+
+void
+writeDiffXML(
+    llvm::raw_ostream& os,
+    CorpusDiff const& diff,
+    Corpus const& before,
+    Corpus const& after)
+{
+    std::string temp;
+    xml::XMLTags tags(os);
+    auto writeSymbol = [&](
+        dom::String const& tag,
+        Info const& I,
+        Corpus const& corpus)
+    {
+        tags.write(tag, corpus.getFullyQualifiedName(I, temp), {
+            { "id", toBase16(I.id) },
+            { "kind", toString(I.Kind) } });
+    };
+    os << "<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n";
+    tags.open("diff");
+    for(Info const* I : diff.added)
+        writeSymbol("added", *I, after);
+    for(Info const* I : diff.removed)
+        writeSymbol("removed", *I, before);
+    for(auto const& [I0, I1] : diff.changed)
+        writeSymbol("changed", *I1, after);
+    tags.close("diff");
+}
+
+} // mrdox
+} // clang
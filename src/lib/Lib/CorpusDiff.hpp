@@ -0,0 +1,79 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#ifndef MRDOX_LIB_CORPUSDIFF_HPP
+#define MRDOX_LIB_CORPUSDIFF_HPP
+
+#include "lib/Lib/CorpusImpl.hpp"
+#include <mrdox/Metadata.hpp>
+#include <llvm/Support/raw_ostream.h>
+#include <utility>
+#include <vector>
+
+namespace clang {
+namespace mrdox {
+
+/** The symbols which differ between two corpora.
+
+    Each list is sorted by symbol ID.
+*/
+struct CorpusDiff
+{
+    /** Symbols which only exist in the new corpus.
+    */
+    std::vector<Info const*> added;
+
+    /** Symbols which only exist in the old corpus.
+    */
+    std::vector<Info const*> removed;
+
+    /** Symbols whose metadata changed.
+
+        The first element of each pair is from the
+        old corpus and the second from the new.
+    */
+    std::vector<std::pair<Info const*, Info const*>> changed;
+};
+
+/** Return the symbols which differ between two corpora.
+
+    The sorted indexes of both corpora are merged.
+    Symbols with the same ID are compared by their
+    content hashes, which each corpus computed
+    once when it was built, or read from its
+    snapshot.
+*/
+Expected<CorpusDiff>
+diffCorpus(
+    CorpusImpl const& before,
+    CorpusImpl const& after);
+
+/** Write a diff as JSON.
+*/
+void
+writeDiffJSON(
+    llvm::raw_ostream& os,
+    CorpusDiff const& diff,
+    Corpus const& before,
+    Corpus const& after);
+
+/** Write a diff as XML.
+*/
+void
+writeDiffXML(
+    llvm::raw_ostream& os,
+    CorpusDiff const& diff,
+    Corpus const& before,
+    Corpus const& after);
+
+} // mrdox
+} // clang
+
+#endif
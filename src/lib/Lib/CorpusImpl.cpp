@@ -10,17 +10,64 @@
 //
 
 #include "lib/AST/Bitcode.hpp"
+#include "lib/AST/BitcodeIDs.hpp"
 #include "lib/AST/ASTVisitor.hpp"
 #include "CorpusImpl.hpp"
+#include "lib/Metadata/Interface.hpp"
 #include "lib/Metadata/Reduce.hpp"
+#include "lib/Support/Compression.hpp"
 #include "lib/Support/Error.hpp"
+#include "lib/Support/Memory.hpp"
+#include "lib/Support/Radix.hpp"
+#include "lib/Support/RawOstream.hpp"
+#include "lib/Support/SafeNames.hpp"
 #include <mrdox/Metadata.hpp>
 #include <mrdox/Support/Error.hpp>
+#include <mrdox/Support/ThreadPool.hpp>
 #include <llvm/ADT/STLExtras.h>
+#include <llvm/Support/Endian.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+#include <llvm/Support/xxhash.h>
+#include <algorithm>
+#include <cstring>
+#include <fstream>
 
 namespace clang {
 namespace mrdox {
 
+namespace {
+
+/*  Corpus snapshot layout
+
+    All integers are little-endian.
+
+    Header
+        char[8]     magic
+        uint32      snapshot version
+        uint32      bitcode version
+        uint64      number of symbols
+
+    Table, sorted by symbol ID
+        uint8[20]   symbol ID
+        uint32      reserved, zero
+        uint64      offset of the bitcode from the start of the file
+        uint64      size of the bitcode
+        uint64      content hash, see CorpusImpl::contentHashes
+
+    Bitcode for each symbol
+*/
+
+constexpr char snapshotMagic[8] = {
+    'M', 'R', 'D', 'O', 'X', 'S', 'N', 'P' };
+constexpr std::uint32_t snapshotVersion = 2;
+constexpr std::size_t snapshotHeaderSize = 24;
+constexpr std::size_t snapshotEntrySize = 48;
+
+namespace endian = llvm::support::endian;
+
+} // (anon)
+
 // A standalone function to call to merge a vector of infos into one.
 // This assumes that all infos in the vector are of the same type, and will fail
 // if they are different.
@@ -79,18 +126,229 @@ find(
     return nullptr;
 }
 
+std::vector<Info const*>
+CorpusImpl::
+findByName(
+    std::string_view name,
+    bool ignoreCase) const
+{
+    return names_.find(name, ignoreCase);
+}
+
+std::vector<Info const*>
+CorpusImpl::
+findByPrefix(
+    std::string_view prefix,
+    bool ignoreCase,
+    std::size_t limit) const
+{
+    return names_.findPrefix(prefix, ignoreCase, limit);
+}
+
+std::string_view
+CorpusImpl::
+qualifiedName(
+    Info const& I) const noexcept
+{
+    if(! names_.built())
+        return {};
+    auto const i = indexOf(I);
+    if(i == index_.size())
+        return {};
+    return names_.name(i);
+}
+
+Interface const*
+CorpusImpl::
+findInterface(
+    RecordInfo const& I) const noexcept
+{
+    auto it = interfaces_.find(&I);
+    if(it != interfaces_.end())
+        return it->second.get();
+    return nullptr;
+}
+
+NamespaceOverloads const*
+CorpusImpl::
+findOverloads(
+    NamespaceInfo const& I) const noexcept
+{
+    auto it = overloads_.find(&I);
+    if(it != overloads_.end())
+        return it->second.get();
+    return nullptr;
+}
+
+std::span<Info const* const>
+CorpusImpl::
+findXRefs(
+    Info const& I,
+    XRefKind kind) const noexcept
+{
+    return xrefs_.find(indexOf(I), kind);
+}
+
+std::string_view
+CorpusImpl::
+getSafeName(
+    SymbolID const& id) const noexcept
+{
+    auto it = safeNames_.find(llvm::StringRef(id));
+    MRDOX_ASSERT(it != safeNames_.end());
+    return it->getValue();
+}
+
+std::size_t
+CorpusImpl::
+indexOf(
+    Info const& I) const noexcept
+{
+    auto it = std::lower_bound(index_.begin(), index_.end(), I.id,
+        [](Info const* J, SymbolID const& id)
+        {
+            return J->id < id;
+        });
+    if(it == index_.end() || (*it)->id != I.id)
+        return index_.size();
+    return it - index_.begin();
+}
+
 //------------------------------------------------
 
-void
+Error
+CorpusImpl::
+insert(std::vector<std::unique_ptr<Info>>&& infos)
+{
+    InfoMap.reserve(InfoMap.size() + infos.size());
+    index_.reserve(index_.size() + infos.size());
+    std::vector<Error> errors;
+    for(auto& I : infos)
+    {
+        if(! I)
+            continue;
+        // The Info is only moved if it was inserted
+        auto const [it, inserted] = InfoMap.try_emplace(
+            StringRef(I->id), std::move(I));
+        if(! inserted)
+        {
+            errors.emplace_back(formatError(
+                "duplicate symbol {}", toBase16(I->id)));
+            continue;
+        }
+        index_.emplace_back(it->second.get());
+    }
+
+    // Keep the index deterministic regardless
+    // of the order in which workers finished.
+    llvm::sort(index_,
+        [](Info const* I0, Info const* I1)
+        {
+            return I0->id < I1->id;
+        });
+    return Error(errors);
+}
+
+Error
 CorpusImpl::
-insert(std::unique_ptr<Info> I)
+buildNameIndex()
 {
-    std::lock_guard<llvm::sys::Mutex> Guard(mutex_);
+    return names_.build(index_, *this, config.threadPool());
+}
+
+Error
+CorpusImpl::
+finalize()
+{
+    // The members of every record are flattened
+    // first, bases before the records deriving
+    // from them, so each base is done only once.
+    InterfaceCache interfaceCache(*this);
+    if(auto err = interfaceCache.build(index_, config.threadPool()))
+        return err;
+
+    // Each task computes the views for a range of
+    // the index into its own slots, and the slots
+    // are moved into the tables at the end.
+    std::size_t const n = index_.size();
+    std::vector<std::unique_ptr<Interface>> interfaces(n);
+    std::vector<std::unique_ptr<NamespaceOverloads>> overloads(n);
+    bool const hashContents = contentHashes_.size() != n;
+    if(hashContents)
+        contentHashes_.assign(n, 0);
+    std::size_t const chunk = std::max<std::size_t>(256,
+        n / (config.threadPool().getThreadCount() * 4 + 1));
+    // The safe names are computed alongside the
+    // other tasks, none of which use them, and
+    // are only stored once all of them are done.
+    llvm::StringMap<std::string> safeNames;
+    TaskGroup taskGroup(config.threadPool());
+    taskGroup.async(
+        [&]
+        {
+            safeNames = makeSafeNames(*this);
+        });
+    for(std::size_t first = 0; first < n; first += chunk)
+    {
+        taskGroup.async(
+            [&, first]
+            {
+                std::size_t const last = std::min(first + chunk, n);
+                for(std::size_t i = first; i < last; ++i)
+                {
+                    Info const& I = *index_[i];
+                    if(hashContents)
+                        contentHashes_[i] = llvm::xxHash64(
+                            writeContentBitcode(I).data);
+                    if(I.isRecord())
+                        interfaces[i] = std::make_unique<Interface>(
+                            interfaceCache.makeInterface(static_cast<
+                                RecordInfo const&>(I)));
+                    else if(I.isNamespace())
+                        overloads[i] = std::make_unique<NamespaceOverloads>(
+                            makeNamespaceOverloads(static_cast<
+                                NamespaceInfo const&>(I), *this));
+                }
+            });
+    }
+    auto errors = taskGroup.wait();
+    if(! errors.empty())
+        return Error(errors);
 
-    index_.emplace_back(I.get());
+    safeNames_ = std::move(safeNames);
+    for(std::size_t i = 0; i < n; ++i)
+    {
+        if(interfaces[i])
+            interfaces_.try_emplace(index_[i], std::move(interfaces[i]));
+        else if(overloads[i])
+            overloads_.try_emplace(index_[i], std::move(overloads[i]));
+    }
+    return xrefs_.build(index_, config.threadPool());
+}
 
-    // This has to come last because we move I.
-    InfoMap[StringRef(I->id)] = std::move(I);
+void
+CorpusImpl::
+recordMemory() const
+{
+    // Only the top-level objects are counted.
+    constexpr std::size_t nKinds =
+        static_cast<std::size_t>(InfoKind::Specialization) + 1;
+    std::size_t counts[nKinds] = {};
+    std::size_t bytes[nKinds] = {};
+    for(Info const* I : index_)
+    {
+        auto const k = static_cast<std::size_t>(I->Kind);
+        ++counts[k];
+        bytes[k] += visit(*I,
+            []<class T>(T const&)
+            {
+                return sizeof(T);
+            });
+    }
+    for(std::size_t k = 0; k < nKinds; ++k)
+        memoryReport().record(fmt::format("corpus.{}",
+            toString(static_cast<InfoKind>(k)).get()),
+            counts[k], bytes[k]);
 }
 
 //------------------------------------------------
@@ -101,8 +359,6 @@ build(
     ToolExecutor& ex,
     std::shared_ptr<ConfigImpl const> config)
 {
-    auto corpus = std::make_unique<CorpusImpl>(config);
-
     // Traverse the AST for all translation units
     // and emit serializd bitcode into tool results.
     // This operation happens ona thread pool.
@@ -116,6 +372,7 @@ build(
         report::warn(
             "Warning: mapping failed because ", err);
     }
+    memoryReport().record("mapping");
 
     // Inject the global namespace
     {
@@ -131,16 +388,37 @@ build(
     // a vector of one or more bitcodes. These will
     // be merged later.
     report::print(ex.getReportLevel(), "Collecting symbols");
+    if(memoryReport().enabled())
+    {
+        std::size_t count = 0;
+        std::size_t bytes = 0;
+        ex.getToolResults()->forEachResult(
+            [&](StringRef Key, StringRef Value)
+            {
+                ++count;
+                bytes += Key.size() + Value.size();
+            });
+        memoryReport().record("tool-results", count, bytes);
+    }
     auto bitcodes = collectBitcodes(ex);
+    memoryReport().record("collect", bitcodes.size(), 0);
 
     // First reducing phase (reduce all decls into one info per decl).
     report::format(ex.getReportLevel(),
         "Reducing {} declarations", bitcodes.size());
     std::atomic<bool> GotFailure;
     GotFailure = false;
-    auto errors = corpus->config.threadPool().forEach(
-        bitcodes,
-        [&](auto& Group)
+
+    // Each symbol is reduced into its own slot,
+    // so the workers never contend on a lock. The
+    // results are inserted once at the end.
+    std::vector<std::unique_ptr<Info>> results(bitcodes.size());
+    TaskGroup taskGroup(config->threadPool());
+    std::size_t n = 0;
+    for(auto& Group : bitcodes)
+    {
+        taskGroup.async(
+        [&, &result = results[n]]
         {
             // One or more Info for the same symbol ID
             std::vector<std::unique_ptr<Info>> Infos;
@@ -169,13 +447,23 @@ build(
                 return;
             }
 
-            std::unique_ptr<Info> I(merged.get().release());
-            MRDOX_ASSERT(Group.getKey() == StringRef(I->id));
-            corpus->insert(std::move(I));
+            result.reset(merged.get().release());
+            MRDOX_ASSERT(Group.getKey() == StringRef(result->id));
         });
+        ++n;
+    }
+    auto errors = taskGroup.wait();
     if(! errors.empty())
         return Error(errors);
 
+    memoryReport().record("reduce", results.size(), 0);
+    auto built = build(std::move(results), config);
+    if(! built)
+        return built.error();
+    auto corpus = std::move(*built);
+    if(memoryReport().enabled())
+        corpus->recordMemory();
+
     report::format(ex.getReportLevel(),
         "Symbols collected: {}", corpus->InfoMap.size());
 
@@ -185,5 +473,199 @@ build(
     return corpus;
 }
 
+mrdox::Expected<std::unique_ptr<CorpusImpl>>
+CorpusImpl::
+build(
+    std::vector<std::unique_ptr<Info>>&& infos,
+    std::shared_ptr<ConfigImpl const> config,
+    std::vector<std::uint64_t> contentHashes)
+{
+    auto corpus = std::make_unique<CorpusImpl>(config);
+    if(auto err = corpus->insert(std::move(infos)))
+        return err;
+    // Hashes of a different length are recomputed
+    corpus->contentHashes_ = std::move(contentHashes);
+    if(auto err = corpus->buildNameIndex())
+        return err;
+    if(auto err = corpus->finalize())
+        return err;
+    memoryReport().record("finalize");
+    return corpus;
+}
+
+mrdox::Expected<std::unique_ptr<Corpus>>
+CorpusImpl::
+load(
+    llvm::StringRef path,
+    std::shared_ptr<ConfigImpl const> config)
+{
+    // Large files are mapped rather than read
+    auto file = llvm::MemoryBuffer::getFile(
+        path, false, false);
+    if(! file)
+        return formatError("could not open the corpus snapshot \"{}\": {}",
+            path, file.getError());
+    llvm::StringRef data = (*file)->getBuffer();
+
+    // Compressed snapshots are expanded in memory
+    std::string text;
+    if(auto compression = getCompression(path);
+        compression != Compression::none)
+    {
+        auto result = decompress(data, compression);
+        if(! result)
+            return formatError("could not decompress the corpus snapshot \"{}\": {}",
+                path, result.error());
+        text = std::move(*result);
+        data = text;
+    }
+    char const* base = data.data();
+
+    if(data.size() < snapshotHeaderSize ||
+        std::memcmp(base, snapshotMagic, sizeof(snapshotMagic)) != 0)
+        return formatError("\"{}\" is not a corpus snapshot", path);
+    auto const version = endian::read32le(base + 8);
+    if(version != snapshotVersion)
+        return formatError("corpus snapshot \"{}\" has version {}, expected {}",
+            path, version, snapshotVersion);
+    auto const bitcodeVersion = endian::read32le(base + 12);
+    if(bitcodeVersion != BitcodeVersion)
+        return formatError("corpus snapshot \"{}\" has bitcode version {}, expected {}",
+            path, bitcodeVersion, BitcodeVersion);
+    auto const count = endian::read64le(base + 16);
+    if(count > (data.size() - snapshotHeaderSize) / snapshotEntrySize)
+        return formatError("corpus snapshot \"{}\" is truncated", path);
+
+    auto entry = [&](std::size_t i)
+    {
+        return base + snapshotHeaderSize +
+            i * snapshotEntrySize;
+    };
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        auto const offset = endian::read64le(entry(i) + 24);
+        auto const size = endian::read64le(entry(i) + 32);
+        if(offset > data.size() || size > data.size() - offset)
+            return formatError("corpus snapshot \"{}\" is truncated", path);
+        // The table is sorted, so a repeated
+        // symbol is next to its duplicate.
+        if(i > 0 && std::memcmp(entry(i - 1), entry(i),
+                SymbolID().size()) >= 0)
+            return formatError("corpus snapshot \"{}\" has unsorted or duplicate symbols", path);
+    }
+
+    // Each symbol is decoded into its own
+    // slot straight from the mapping.
+    std::vector<std::unique_ptr<Info>> results(count);
+    std::vector<std::uint64_t> contentHashes(count);
+    TaskGroup taskGroup(config->threadPool());
+    for(std::size_t i = 0; i < count; ++i)
+    {
+        taskGroup.async(
+        [&, i]
+        {
+            char const* p = entry(i);
+            auto bitcode = data.substr(
+                endian::read64le(p + 24),
+                endian::read64le(p + 32));
+            auto infos = readBitcode(bitcode);
+            if(! infos)
+                infos.error().Throw();
+            if(infos->size() != 1 || std::memcmp(p,
+                infos->front()->id.data(), SymbolID().size()) != 0)
+                formatError("symbol table mismatch").Throw();
+            results[i] = std::move(infos->front());
+            contentHashes[i] = endian::read64le(p + 40);
+        });
+    }
+    auto errors = taskGroup.wait();
+    if(! errors.empty())
+        return Error(errors);
+
+    memoryReport().record("load", count, data.size());
+    auto corpus = build(std::move(results), config,
+        std::move(contentHashes));
+    if(! corpus)
+        return corpus.error();
+    return std::move(*corpus);
+}
+
+Error
+CorpusImpl::
+save(
+    llvm::StringRef path) const
+{
+    // Serialize in parallel, then write in order
+    std::vector<Bitcode> bitcodes(index_.size());
+    TaskGroup taskGroup(config.threadPool());
+    for(std::size_t i = 0; i < index_.size(); ++i)
+        taskGroup.async(
+        [&, i]
+        {
+            bitcodes[i] = writeBitcode(*index_[i]);
+        });
+    auto errors = taskGroup.wait();
+    if(! errors.empty())
+        return Error(errors);
+
+    auto write = [&](llvm::raw_ostream& os)
+    {
+        char buf[snapshotEntrySize] = {};
+        std::memcpy(buf, snapshotMagic, sizeof(snapshotMagic));
+        endian::write32le(buf + 8, snapshotVersion);
+        endian::write32le(buf + 12, BitcodeVersion);
+        endian::write64le(buf + 16, bitcodes.size());
+        os.write(buf, snapshotHeaderSize);
+
+        std::uint64_t offset = snapshotHeaderSize +
+            bitcodes.size() * snapshotEntrySize;
+        for(std::size_t i = 0; i < bitcodes.size(); ++i)
+        {
+            auto const& bc = bitcodes[i];
+            std::memset(buf, 0, sizeof(buf));
+            std::memcpy(buf, bc.id.data(), bc.id.size());
+            endian::write64le(buf + 24, offset);
+            endian::write64le(buf + 32, bc.data.size());
+            endian::write64le(buf + 40, contentHashes_[i]);
+            os.write(buf, snapshotEntrySize);
+            offset += bc.data.size();
+        }
+        for(auto const& bc : bitcodes)
+            os << bc.data;
+    };
+
+    Compression const compression = getCompression(path);
+    if(compression == Compression::none)
+    {
+        std::error_code ec;
+        llvm::raw_fd_ostream os(path, ec);
+        if(ec)
+            return formatError("could not write the corpus snapshot \"{}\": {}",
+                path, ec);
+        write(os);
+        os.close();
+        if(os.has_error())
+            return formatError("could not write the corpus snapshot \"{}\": {}",
+                path, os.error());
+        return Error::success();
+    }
+
+    if(auto err = requireCompression(compression))
+        return err;
+    std::ofstream file(path.str(),
+        std::ios_base::binary | std::ios_base::trunc);
+    if(! file)
+        return formatError("could not write the corpus snapshot \"{}\"", path);
+    CompressedOstream cos(file, compression);
+    {
+        RawOstream os(cos);
+        write(os);
+    }
+    if(auto err = cos.close())
+        return formatError("could not write the corpus snapshot \"{}\": {}",
+            path, err);
+    return Error::success();
+}
+
 } // mrdox
 } // clang
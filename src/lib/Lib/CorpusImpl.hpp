@@ -12,15 +12,19 @@
 #define MRDOX_LIB_CORPUSIMPL_HPP
 
 #include "lib/Lib/ConfigImpl.hpp"
+#include "lib/Lib/NameIndex.hpp"
 #include "lib/Lib/ToolExecutor.hpp"
+#include "lib/Lib/XRefIndex.hpp"
 #include "lib/Support/Debug.hpp"
 #include <mrdox/Corpus.hpp>
 #include <mrdox/Metadata.hpp>
 #include <mrdox/Platform.hpp>
 #include <mrdox/Support/Error.hpp>
+#include <llvm/ADT/DenseMap.h>
 #include <llvm/ADT/StringMap.h>
-#include <llvm/Support/Mutex.h>
+#include <cstdint>
 #include <string>
+#include <vector>
 
 namespace clang {
 namespace mrdox {
@@ -57,6 +61,79 @@ public:
         ToolExecutor& ex,
         std::shared_ptr<ConfigImpl const> config);
 
+    /** Build a corpus from symbols already extracted.
+
+        The symbols are inserted, and the views
+        derived from them are computed.
+
+        @return The corpus, or an error if a
+        symbol ID appears more than once.
+
+        @param infos The symbols, one per ID.
+        Null elements are ignored.
+
+        @param config A shared pointer to the configuration.
+
+        @param contentHashes The content hashes of
+        the symbols, in ascending order of ID, if
+        they are already known. Otherwise they are
+        computed.
+    */
+    [[nodiscard]]
+    static
+    mrdox::Expected<std::unique_ptr<CorpusImpl>>
+    build(
+        std::vector<std::unique_ptr<Info>>&& infos,
+        std::shared_ptr<ConfigImpl const> config,
+        std::vector<std::uint64_t> contentHashes = {});
+
+    /** Load a corpus from a snapshot file.
+
+        The file is memory-mapped and the symbols
+        are decoded in parallel directly from the
+        mapping, without running the extraction.
+        A snapshot whose symbol IDs are not in
+        strictly ascending order is rejected.
+
+        @param path The path to a file written
+        by @ref save.
+
+        @param config A shared pointer to the configuration.
+    */
+    [[nodiscard]]
+    static
+    mrdox::Expected<std::unique_ptr<Corpus>>
+    load(
+        llvm::StringRef path,
+        std::shared_ptr<ConfigImpl const> config);
+
+    /** Write a snapshot of the corpus to a file.
+
+        The snapshot begins with a header and a
+        table of symbol IDs sorted in ascending
+        order, each with the offset and size of
+        the bitcode for that symbol.
+
+        @param path The path of the file to write.
+    */
+    Error
+    save(
+        llvm::StringRef path) const;
+
+    /** Return the content hash of each symbol.
+
+        The hashes are in the order of the index.
+        Each is a hash of the encoding of the symbol
+        without line numbers and with its javadoc
+        parsed, so that two corpora can be compared
+        without encoding their symbols again.
+    */
+    std::vector<std::uint64_t> const&
+    contentHashes() const noexcept
+    {
+        return contentHashes_;
+    }
+
 private:
     std::vector<Info const*> const&
     index() const noexcept override
@@ -68,6 +145,47 @@ private:
     find(
         SymbolID const& id) const noexcept override;
 
+    std::vector<Info const*>
+    findByName(
+        std::string_view name,
+        bool ignoreCase) const override;
+
+    std::vector<Info const*>
+    findByPrefix(
+        std::string_view prefix,
+        bool ignoreCase,
+        std::size_t limit) const override;
+
+    std::string_view
+    qualifiedName(
+        Info const& I) const noexcept override;
+
+    Interface const*
+    findInterface(
+        RecordInfo const& I) const noexcept override;
+
+    NamespaceOverloads const*
+    findOverloads(
+        NamespaceInfo const& I) const noexcept override;
+
+    std::span<Info const* const>
+    findXRefs(
+        Info const& I,
+        XRefKind kind) const noexcept override;
+
+    std::string_view
+    getSafeName(
+        SymbolID const& id) const noexcept override;
+
+    /** Return the position of a symbol in the index.
+
+        This returns the size of the index
+        if the symbol is not in the corpus.
+    */
+    std::size_t
+    indexOf(
+        Info const& I) const noexcept;
+
     /** Return the Info with the specified symbol ID.
 
         If the id does not exist, the behavior is undefined.
@@ -77,12 +195,46 @@ private:
     get(
         SymbolID const& id) noexcept;
 
-    /** Insert this element and all its children into the Corpus.
+    /** Insert the reduced symbols into the Corpus.
+
+        This builds the table of symbols and the
+        index, which is sorted by symbol ID so that
+        the order does not depend on scheduling.
+        Null elements are ignored.
+
+        @return An error if a symbol is already
+        in the corpus. The existing symbol is
+        kept, since other symbols may refer to it.
+
+        @par Thread Safety
+        May not be called concurrently. This is
+        called once, after the reduce phase has
+        completed on all threads.
+    */
+    Error insert(std::vector<std::unique_ptr<Info>>&& infos);
+
+    /** Build the index of symbols by qualified name.
+
+        This is called once, after @ref insert.
+    */
+    Error buildNameIndex();
+
+    /** Compute the views derived from the symbols.
+
+        The interface of each record, the overload
+        sets of each namespace, the safe names, the
+        content hashes if they are not known, and
+        the references between symbols are computed
+        in parallel and stored, so that generators
+        only need to look them up.
+
+        This is called once, after @ref insert.
+    */
+    Error finalize();
 
-        @param Thread Safety
-        May be called concurrently.
+    /** Record the size of the corpus by kind in the memory report.
     */
-    void insert(std::unique_ptr<Info> Ip);
+    void recordMemory() const;
 
 private:
     struct Temps;
@@ -93,8 +245,14 @@ private:
     // Table of Info keyed on Symbol ID.
     llvm::StringMap<std::unique_ptr<Info>> InfoMap;
     std::vector<Info const*> index_;
+    NameIndex names_;
 
-    llvm::sys::Mutex mutex_;
+    // Views computed by finalize()
+    llvm::DenseMap<Info const*, std::unique_ptr<Interface>> interfaces_;
+    llvm::DenseMap<Info const*, std::unique_ptr<NamespaceOverloads>> overloads_;
+    llvm::StringMap<std::string> safeNames_;
+    std::vector<std::uint64_t> contentHashes_;
+    XRefIndex xrefs_;
 };
 
 template<class T>
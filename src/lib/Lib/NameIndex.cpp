@@ -0,0 +1,136 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#include "lib/Lib/NameIndex.hpp"
+#include <llvm/ADT/STLExtras.h>
+#include <llvm/ADT/StringExtras.h>
+#include <algorithm>
+
+namespace clang {
+namespace mrdox {
+
+namespace {
+
+int
+compareIgnoreCase(
+    std::string_view s0,
+    std::string_view s1) noexcept
+{
+    return llvm::StringRef(s0).compare_insensitive(s1);
+}
+
+bool
+startsWithIgnoreCase(
+    std::string_view s,
+    std::string_view prefix) noexcept
+{
+    return llvm::StringRef(s).startswith_insensitive(prefix);
+}
+
+} // (anon)
+
+Error
+NameIndex::
+build(
+    std::vector<Info const*> const& index,
+    Corpus const& corpus,
+    ThreadPool& threadPool)
+{
+    index_ = &index;
+    built_ = false;
+    names_.clear();
+    names_.resize(index.size());
+
+    // Each task names a contiguous range of the index
+    std::size_t const n = index.size();
+    std::size_t const chunk = std::max<std::size_t>(1024,
+        n / (threadPool.getThreadCount() * 4 + 1));
+    TaskGroup taskGroup(threadPool);
+    for(std::size_t first = 0; first < n; first += chunk)
+    {
+        taskGroup.async(
+            [&, first]
+            {
+                std::size_t const last = std::min(first + chunk, n);
+                std::string temp;
+                for(std::size_t i = first; i < last; ++i)
+                    names_[i] = corpus.getFullyQualifiedName(*index[i], temp);
+            });
+    }
+    auto errors = taskGroup.wait();
+    if(! errors.empty())
+        return Error(errors);
+
+    sorted_.resize(n);
+    for(std::size_t i = 0; i < n; ++i)
+        sorted_[i] = static_cast<std::uint32_t>(i);
+    llvm::sort(sorted_,
+        [&](std::uint32_t i0, std::uint32_t i1)
+        {
+            if(int cmp = compareIgnoreCase(names_[i0], names_[i1]))
+                return cmp < 0;
+            if(names_[i0] != names_[i1])
+                return names_[i0] < names_[i1];
+            // Overloads stay in the order of the index
+            return i0 < i1;
+        });
+    built_ = true;
+    return Error::success();
+}
+
+std::vector<Info const*>
+NameIndex::
+find(
+    std::string_view name,
+    bool ignoreCase) const
+{
+    // The names which match without regard
+    // to case are adjacent in the order.
+    auto [first, last] = std::equal_range(
+        sorted_.begin(), sorted_.end(), name,
+        [&]<class T0, class T1>(T0 const& v0, T1 const& v1)
+        {
+            if constexpr(std::is_same_v<T0, std::uint32_t>)
+                return compareIgnoreCase(names_[v0], v1) < 0;
+            else
+                return compareIgnoreCase(v0, names_[v1]) < 0;
+        });
+    std::vector<Info const*> result;
+    for(auto it = first; it != last; ++it)
+        if(ignoreCase || names_[*it] == name)
+            result.push_back((*index_)[*it]);
+    return result;
+}
+
+std::vector<Info const*>
+NameIndex::
+findPrefix(
+    std::string_view prefix,
+    bool ignoreCase,
+    std::size_t limit) const
+{
+    auto it = std::lower_bound(
+        sorted_.begin(), sorted_.end(), prefix,
+        [&](std::uint32_t i, std::string_view s)
+        {
+            return compareIgnoreCase(names_[i], s) < 0;
+        });
+    std::vector<Info const*> result;
+    for(; it != sorted_.end() && result.size() < limit &&
+        startsWithIgnoreCase(names_[*it], prefix); ++it)
+    {
+        if(ignoreCase || names_[*it].starts_with(prefix))
+            result.push_back((*index_)[*it]);
+    }
+    return result;
+}
+
+} // mrdox
+} // clang
@@ -0,0 +1,90 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#ifndef MRDOX_LIB_NAMEINDEX_HPP
+#define MRDOX_LIB_NAMEINDEX_HPP
+
+#include <mrdox/Corpus.hpp>
+#include <mrdox/Metadata.hpp>
+#include <mrdox/Support/Error.hpp>
+#include <mrdox/Support/ThreadPool.hpp>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace clang {
+namespace mrdox {
+
+/** An index of symbols by fully qualified name.
+
+    The names are ordered without regard to case
+    first, so that the names which match a string
+    or a prefix either with or without regard to
+    case are adjacent.
+*/
+class NameIndex
+{
+    std::vector<Info const*> const* index_ = nullptr;
+    std::vector<std::string> names_;
+    std::vector<std::uint32_t> sorted_;
+    bool built_ = false;
+
+public:
+    /** Build the index.
+
+        The names are computed in parallel and are
+        stored in the same order as the symbols in
+        `index`, which must outlive this object.
+    */
+    Error
+    build(
+        std::vector<Info const*> const& index,
+        Corpus const& corpus,
+        ThreadPool& threadPool);
+
+    /** Return true if the index has been built.
+    */
+    bool
+    built() const noexcept
+    {
+        return built_;
+    }
+
+    /** Return the name of the symbol at a position in the index.
+    */
+    std::string_view
+    name(std::size_t i) const noexcept
+    {
+        return names_[i];
+    }
+
+    /** Return the symbols with a fully qualified name.
+    */
+    std::vector<Info const*>
+    find(
+        std::string_view name,
+        bool ignoreCase) const;
+
+    /** Return the symbols whose fully qualified name starts with a prefix.
+
+        At most `limit` symbols are returned.
+    */
+    std::vector<Info const*>
+    findPrefix(
+        std::string_view prefix,
+        bool ignoreCase,
+        std::size_t limit) const;
+};
+
+} // mrdox
+} // clang
+
+#endif
@@ -0,0 +1,245 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#include "lib/Lib/XRefIndex.hpp"
+#include <llvm/ADT/STLExtras.h>
+#include <algorithm>
+
+namespace clang {
+namespace mrdox {
+
+namespace {
+
+constexpr std::size_t nKinds =
+    static_cast<std::size_t>(XRefKind::FriendOf) + 1;
+
+// A reference from the symbol at position `from`
+// to the symbol at position `to`, in the slot
+// for the kind of reference.
+struct Edge
+{
+    std::uint32_t slot;
+    std::uint32_t from;
+};
+
+/*  Collects the references made by one symbol.
+*/
+class EdgeCollector
+{
+    std::vector<Info const*> const& index_;
+    std::vector<Edge>& edges_;
+    std::vector<SymbolID> types_;
+    std::uint32_t from_ = 0;
+
+    void
+    add(
+        SymbolID const& id,
+        XRefKind kind)
+    {
+        auto it = std::lower_bound(index_.begin(), index_.end(), id,
+            [](Info const* I, SymbolID const& id)
+            {
+                return I->id < id;
+            });
+        if(it == index_.end() || (*it)->id != id)
+            return;
+        auto const to = static_cast<std::size_t>(it - index_.begin());
+        edges_.push_back({ static_cast<std::uint32_t>(
+            static_cast<std::size_t>(kind) * index_.size() + to), from_ });
+    }
+
+    void
+    addTemplate(
+        std::unique_ptr<TemplateInfo> const& T)
+    {
+        if(T && T->Primary)
+            add(*T->Primary, XRefKind::Specializations);
+    }
+
+    // Gather the symbols named anywhere in a type
+    void
+    collectType(
+        std::unique_ptr<TypeInfo> const& T)
+    {
+        if(! T)
+            return;
+        visit(*T,
+            [&]<class U>(U const& t)
+            {
+                if constexpr(requires { t.id; })
+                {
+                    if(t.id != SymbolID::zero)
+                        types_.push_back(t.id);
+                }
+                if constexpr(U::isSpecialization())
+                {
+                    for(auto const& A : t.TemplateArgs)
+                        visit(*A,
+                            [&]<class V>(V const& a)
+                            {
+                                if constexpr(V::isType())
+                                    collectType(a.Type);
+                                if constexpr(V::isTemplate())
+                                    types_.push_back(a.Template);
+                            });
+                }
+                // The class of a member pointer, and the
+                // enclosing class of a nested tag type
+                if constexpr(requires { t.ParentType; })
+                    collectType(t.ParentType);
+                if constexpr(requires { t.PointeeType; })
+                    collectType(t.PointeeType);
+                if constexpr(U::isArray())
+                    collectType(t.ElementType);
+                if constexpr(U::isFunction())
+                {
+                    collectType(t.ReturnType);
+                    for(auto const& P : t.ParamTypes)
+                        collectType(P);
+                }
+                if constexpr(U::isPack())
+                    collectType(t.PatternType);
+            });
+    }
+
+    // Each type is referenced once per symbol
+    void
+    addTypes()
+    {
+        llvm::sort(types_);
+        types_.erase(std::unique(types_.begin(), types_.end()), types_.end());
+        for(auto const& id : types_)
+            add(id, XRefKind::ReferencedBy);
+        types_.clear();
+    }
+
+public:
+    EdgeCollector(
+        std::vector<Info const*> const& index,
+        std::vector<Edge>& edges) noexcept
+        : index_(index)
+        , edges_(edges)
+    {
+    }
+
+    void
+    operator()(std::size_t i)
+    {
+        from_ = static_cast<std::uint32_t>(i);
+        visit(*index_[i],
+            [&]<class T>(T const& I)
+            {
+                if constexpr(T::isRecord())
+                {
+                    for(auto const& B : I.Bases)
+                    {
+                        if(! B.Type)
+                            continue;
+                        visit(*B.Type,
+                            [&]<class U>(U const& t)
+                            {
+                                if constexpr(requires { t.id; })
+                                    add(t.id, XRefKind::Derived);
+                            });
+                    }
+                    for(auto const& id : I.Friends)
+                        add(id, XRefKind::FriendOf);
+                }
+                if constexpr(T::isSpecialization())
+                    add(I.Primary, XRefKind::Specializations);
+                if constexpr(requires { I.Template; })
+                    addTemplate(I.Template);
+                if constexpr(T::isFunction())
+                {
+                    collectType(I.ReturnType);
+                    for(auto const& P : I.Params)
+                        collectType(P.Type);
+                    addTypes();
+                }
+                if constexpr(
+                    T::isField() ||
+                    T::isVariable() ||
+                    T::isTypedef())
+                {
+                    collectType(I.Type);
+                    addTypes();
+                }
+            });
+    }
+};
+
+} // (anon)
+
+Error
+XRefIndex::
+build(
+    std::vector<Info const*> const& index,
+    ThreadPool& threadPool)
+{
+    size_ = 0;
+    offsets_.clear();
+    refs_.clear();
+
+    // Each task collects the references made
+    // by a contiguous range of the index.
+    std::size_t const n = index.size();
+    std::size_t const chunk = std::max<std::size_t>(1024,
+        n / (threadPool.getThreadCount() * 4 + 1));
+    std::vector<std::vector<Edge>> edges((n + chunk - 1) / chunk);
+    TaskGroup taskGroup(threadPool);
+    for(std::size_t first = 0; first < n; first += chunk)
+    {
+        taskGroup.async(
+            [&, first]
+            {
+                std::size_t const last = std::min(first + chunk, n);
+                EdgeCollector collect(index, edges[first / chunk]);
+                for(std::size_t i = first; i < last; ++i)
+                    collect(i);
+            });
+    }
+    auto errors = taskGroup.wait();
+    if(! errors.empty())
+        return Error(errors);
+
+    // Count the references to each slot, then place
+    // them. The ranges are visited in order, so the
+    // symbols in each slot are in the order of the index.
+    offsets_.assign(nKinds * n + 1, 0);
+    for(auto const& list : edges)
+        for(auto const& e : list)
+            ++offsets_[e.slot + 1];
+    for(std::size_t i = 1; i < offsets_.size(); ++i)
+        offsets_[i] += offsets_[i - 1];
+    refs_.resize(offsets_.back());
+    std::vector<std::uint32_t> next(
+        offsets_.begin(), offsets_.end() - 1);
+    for(auto const& list : edges)
+        for(auto const& e : list)
+            refs_[next[e.slot]++] = index[e.from];
+    size_ = n;
+    return Error::success();
+}
+
+std::span<Info const* const>
+XRefIndex::
+find(
+    std::size_t i,
+    XRefKind kind) const noexcept
+{
+    if(i >= size_)
+        return {};
+    auto const slot = static_cast<std::size_t>(kind) * size_ + i;
+    return std::span<Info const* const>(refs_).subspan(
+        offsets_[slot], offsets_[slot + 1] - offsets_[slot]);
+}
+
+} // mrdox
+} // clang
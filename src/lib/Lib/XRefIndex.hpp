@@ -0,0 +1,65 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#ifndef MRDOX_LIB_XREFINDEX_HPP
+#define MRDOX_LIB_XREFINDEX_HPP
+
+#include <mrdox/Corpus.hpp>
+#include <mrdox/Metadata.hpp>
+#include <mrdox/Support/Error.hpp>
+#include <mrdox/Support/ThreadPool.hpp>
+#include <cstdint>
+#include <span>
+#include <vector>
+
+namespace clang {
+namespace mrdox {
+
+/** An index of the references between symbols.
+
+    For each kind of reference and each symbol,
+    the symbols which refer to it are stored in
+    one contiguous array, with a table of offsets
+    into it indexed by kind and position.
+*/
+class XRefIndex
+{
+    std::size_t size_ = 0;
+    std::vector<std::uint32_t> offsets_;
+    std::vector<Info const*> refs_;
+
+public:
+    /** Build the index.
+
+        The references are collected in parallel
+        from ranges of `index`, which must be sorted
+        by symbol ID. References to symbols which
+        are not in the index are ignored.
+    */
+    Error
+    build(
+        std::vector<Info const*> const& index,
+        ThreadPool& threadPool);
+
+    /** Return the symbols which refer to the symbol at a position in the index.
+
+        The result is empty if the index
+        has not been built.
+    */
+    std::span<Info const* const>
+    find(
+        std::size_t i,
+        XRefKind kind) const noexcept;
+};
+
+} // mrdox
+} // clang
+
+#endif
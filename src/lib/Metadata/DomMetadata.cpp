@@ -512,13 +512,13 @@ template<class T>
 class DomTrancheArray : public dom::ArrayImpl
 {
     std::span<T const*> list_;
-    std::shared_ptr<Interface> sp_;
+    std::shared_ptr<void const> sp_; // owner of list_
     DomCorpus const& domCorpus_;
 
 public:
     DomTrancheArray(
         std::span<T const*> list,
-        std::shared_ptr<Interface> const& sp,
+        std::shared_ptr<void const> const& sp,
         DomCorpus const& domCorpus)
         : list_(list)
         , sp_(sp)
@@ -540,7 +540,7 @@ public:
 
 class DomTranche : public dom::DefaultObjectImpl
 {
-    std::shared_ptr<Interface> sp_;
+    std::shared_ptr<Interface const> sp_;
     Interface::Tranche const& tranche_;
     DomCorpus const& domCorpus_;
 
@@ -549,7 +549,7 @@ class DomTranche : public dom::DefaultObjectImpl
     dom::Value
     init(
         std::span<T const*> list,
-        std::shared_ptr<Interface> const& sp,
+        std::shared_ptr<Interface const> const& sp,
         DomCorpus const& domCorpus)
     {
         return dom::newArray<DomTrancheArray<T>>(list, sp, domCorpus);
@@ -558,7 +558,7 @@ class DomTranche : public dom::DefaultObjectImpl
 public:
     DomTranche(
         Interface::Tranche const& tranche,
-        std::shared_ptr<Interface> const& sp,
+        std::shared_ptr<Interface const> const& sp,
         DomCorpus const& domCorpus) noexcept
         : dom::DefaultObjectImpl({
             { "records",    init(tranche.Records, sp, domCorpus) },
@@ -580,7 +580,7 @@ class DomInterface : public dom::LazyObjectImpl
 {
     RecordInfo const& I_;
     DomCorpus const& domCorpus_;
-    std::shared_ptr<Interface> mutable sp_;
+    std::shared_ptr<Interface const> mutable sp_;
 
 public:
     DomInterface(
@@ -594,7 +594,14 @@ public:
     dom::Object
     construct() const override
     {
-        sp_ = std::make_shared<Interface>(makeInterface(I_, domCorpus_.corpus));
+        // The corpus keeps the interfaces it computed,
+        // otherwise this object owns a new one.
+        if(auto p = domCorpus_.corpus.findInterface(I_))
+            sp_ = std::shared_ptr<Interface const>(
+                std::shared_ptr<void>(), p);
+        else
+            sp_ = std::make_shared<Interface const>(
+                makeInterface(I_, domCorpus_.corpus));
         return dom::Object({
             { "public", dom::newObject<DomTranche>(sp_->Public, sp_, domCorpus_) },
             { "protected", dom::newObject<DomTranche>(sp_->Protected, sp_, domCorpus_) },
@@ -603,6 +610,101 @@ public:
     }
 };
 
+//------------------------------------------------
+//
+// NamespaceOverloads
+//
+//------------------------------------------------
+
+class DomOverloadsArray : public dom::ArrayImpl
+{
+    std::shared_ptr<NamespaceOverloads const> sp_;
+    DomCorpus const& domCorpus_;
+
+public:
+    DomOverloadsArray(
+        NamespaceInfo const& I,
+        DomCorpus const& domCorpus)
+        : domCorpus_(domCorpus)
+    {
+        if(auto p = domCorpus_.corpus.findOverloads(I))
+            sp_ = std::shared_ptr<NamespaceOverloads const>(
+                std::shared_ptr<void>(), p);
+        else
+            sp_ = std::make_shared<NamespaceOverloads const>(
+                makeNamespaceOverloads(I, domCorpus_.corpus));
+    }
+
+    std::size_t size() const noexcept override
+    {
+        return sp_->list.size();
+    }
+
+    dom::Value get(std::size_t i) const override
+    {
+        MRDOX_ASSERT(i < sp_->list.size());
+        auto const& overloads = sp_->list[i];
+        return dom::Object({
+            { "name", overloads.Name },
+            { "functions", dom::newArray<DomTrancheArray<FunctionInfo>>(
+                overloads.Functions, sp_, domCorpus_) }
+            });
+    }
+};
+
+//------------------------------------------------
+//
+// References
+//
+//------------------------------------------------
+
+class DomXRefArray : public dom::ArrayImpl
+{
+    Info const& I_;
+    XRefKind kind_;
+    DomCorpus const& domCorpus_;
+    mutable std::once_flag once_;
+    mutable std::span<Info const* const> list_;
+
+    // The lookup is a search of the index, so it
+    // is only done when the array is first used,
+    // and the slice is kept afterwards. Most
+    // symbols are rendered without their references.
+    std::span<Info const* const>
+    list() const
+    {
+        std::call_once(once_,
+            [&]
+            {
+                list_ = domCorpus_.corpus.findXRefs(I_, kind_);
+            });
+        return list_;
+    }
+
+public:
+    DomXRefArray(
+        Info const& I,
+        XRefKind kind,
+        DomCorpus const& domCorpus) noexcept
+        : I_(I)
+        , kind_(kind)
+        , domCorpus_(domCorpus)
+    {
+    }
+
+    std::size_t size() const noexcept override
+    {
+        return list().size();
+    }
+
+    dom::Value get(std::size_t i) const override
+    {
+        auto const list = this->list();
+        MRDOX_ASSERT(i < list.size());
+        return domCorpus_.get(*list[i]);
+    }
+};
+
 //------------------------------------------------
 //
 // Info
@@ -659,17 +761,29 @@ DomInfo<T>::construct() const
         { "name",       I_.Name },
         { "namespace",  dom::newArray<DomSymbolArray>(
                             I_.Namespace, domCorpus_) },
-        { "doc",        domCreate(I_.javadoc, domCorpus_) }
+        { "doc",        domCreate(I_.javadoc, domCorpus_) },
+        { "referencedBy", dom::newArray<DomXRefArray>(
+                            I_, XRefKind::ReferencedBy, domCorpus_) },
+        { "friendOf",   dom::newArray<DomXRefArray>(
+                            I_, XRefKind::FriendOf, domCorpus_) }
         });
     if constexpr(std::derived_from<T, SourceInfo>)
     {
         entries.emplace_back("loc", domCreate(I_));
     }
+    if constexpr(requires { I_.Template; })
+    {
+        entries.emplace_back("templateSpecializations",
+            dom::newArray<DomXRefArray>(
+                I_, XRefKind::Specializations, domCorpus_));
+    }
     if constexpr(T::isNamespace())
     {
         entries.insert(entries.end(), {
             { "members", dom::newArray<DomSymbolArray>(
                 I_.Members, domCorpus_) },
+            { "overloads", dom::newArray<DomOverloadsArray>(
+                I_, domCorpus_) },
             { "specializations", nullptr }
             });
     }
@@ -684,6 +798,8 @@ DomInfo<T>::construct() const
             { "members",        dom::newArray<DomSymbolArray>(I_.Members, domCorpus_) },
             { "specializations",dom::newArray<DomSymbolArray>(I_.Specializations, domCorpus_) },
             { "interface",      dom::newObject<DomInterface>(I_, domCorpus_) },
+            { "derived",        dom::newArray<DomXRefArray>(
+                                    I_, XRefKind::Derived, domCorpus_) },
             { "template",       domCreate(I_.Template, domCorpus_) }
             });
     }
@@ -799,6 +915,13 @@ public:
     {
     }
 
+    std::size_t
+    size()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return infoCache_.size();
+    }
+
     dom::Object
     create(SymbolID const& id)
     {
@@ -893,5 +1016,12 @@ getJavadoc(
     return nullptr;
 }
 
+std::size_t
+DomCorpus::
+cachedCount() const
+{
+    return impl_->size();
+}
+
 } // mrdox
 } // clang
@@ -9,6 +9,7 @@
 // Official repository: https://github.com/cppalliance/mrdox
 //
 
+#include "lib/Metadata/Interface.hpp"
 #include "lib/Support/Debug.hpp"
 #include <mrdox/Metadata/Interface.hpp>
 #include <mrdox/Support/TypeTraits.hpp>
@@ -19,107 +20,185 @@
 #include <mrdox/Metadata/Record.hpp>
 #include <mrdox/Metadata/Typedef.hpp>
 #include <mrdox/Metadata/Variable.hpp>
+#include <llvm/ADT/STLExtras.h>
 #include <algorithm>
 
 namespace clang {
 namespace mrdox {
 
-//------------------------------------------------
+namespace {
 
-class Interface::Build
+AccessKind
+effectiveAccess(
+    AccessKind t0,
+    AccessKind t1) noexcept
 {
-    Interface& I_;
-    Corpus const& corpus_;
-    bool includePrivate_;
+    if( t0 ==  AccessKind::Private ||
+        t1 ==  AccessKind::Private)
+        return AccessKind::Private;
 
-    template<class T>
-    using Table = std::vector<
-        std::pair<AccessKind, T const*>>;
+    if( t0 ==  AccessKind::Protected ||
+        t1 ==  AccessKind::Protected)
+        return AccessKind::Protected;
 
-    Table<RecordInfo>       records_;
-    Table<FunctionInfo>     functions_;
-    Table<EnumInfo>         enums_;
-    Table<TypedefInfo>      types_;
-    Table<FieldInfo>        data_;
-    Table<FunctionInfo>     staticfuncs_;
-    Table<VariableInfo>     staticdata_;
+    return AccessKind::Public;
+}
 
-public:
-    Build(
-        Interface& I,
-        RecordInfo const& Derived,
-        Corpus const& corpus) noexcept
-        : I_(I)
-        , corpus_(corpus)
-        , includePrivate_(corpus_.config->includePrivate)
+// Return the record named by a base,
+// or nullptr if it is not in the corpus.
+RecordInfo const*
+findBase(
+    BaseInfo const& B,
+    Corpus const& corpus) noexcept
+{
+    if(! B.Type)
+        return nullptr;
+    SymbolID id = SymbolID::zero;
+    visit(*B.Type,
+        [&]<class T>(T const& t)
+        {
+            if constexpr(requires { t.id; })
+                id = t.id;
+        });
+    if(id == SymbolID::zero)
+        return nullptr;
+    Info const* I = corpus.find(id);
+    if(! I || ! I->isRecord())
+        return nullptr;
+    return static_cast<RecordInfo const*>(I);
+}
+
+} // (anon)
+
+//------------------------------------------------
+
+/*  The members of a record and of its bases.
+
+    The members declared in the record are stored
+    with the access they have in the record. The
+    members of each base are not copied, they are
+    referred to and combined when an interface is
+    made, so each record's own members are stored
+    once however deep the hierarchy is.
+*/
+struct InterfaceMembers
+{
+    template<class T>
+    struct Entry
     {
-        // treat `Derived` as a public base,
-        append(AccessKind::Public, Derived);
+        AccessKind access;
+        T const* I;
 
-        finish();
-    }
+        // A virtual function of a record which is not
+        // final is listed even when it is private.
+        bool overridable = false;
+    };
 
-private:
-    static
-    AccessKind
-    effectiveAccess(
-        AccessKind t0,
-        AccessKind t1) noexcept
+    template<class T>
+    using Table = std::vector<Entry<T>>;
+
+    struct Base
     {
-        if( t0 ==  AccessKind::Private ||
-            t1 ==  AccessKind::Private)
-            return AccessKind::Private;
+        AccessKind access;
+        InterfaceMembers const* members;
+    };
 
-        if( t0 ==  AccessKind::Protected ||
-            t1 ==  AccessKind::Protected)
-            return AccessKind::Protected;
+    std::vector<Base>       bases;
+    Table<RecordInfo>       records;
+    Table<FunctionInfo>     functions;
+    Table<EnumInfo>         enums;
+    Table<TypedefInfo>      types;
+    Table<FieldInfo>        data;
+    Table<FunctionInfo>     staticfuncs;
+    Table<VariableInfo>     staticdata;
 
-        return AccessKind::Public;
-    }
+    /*  Compute the members of a record.
 
+        `getBase` returns the members of a base,
+        or nullptr if the base contributes none.
+        The returned members must outlive these.
+    */
+    template<class GetBase>
     void
-    append(
-        AccessKind access,
-        RecordInfo const& From)
+    build(
+        RecordInfo const& From,
+        Corpus const& corpus,
+        GetBase&& getBase)
     {
+        bool const includePrivate = corpus.config->includePrivate;
         for(auto const& B : From.Bases)
         {
-            auto actualAccess = effectiveAccess(access, B.Access);
-            if( ! includePrivate_ &&
-                actualAccess == AccessKind::Private)
+            if( ! includePrivate &&
+                B.Access == AccessKind::Private)
                 continue;
-            // VFALCO temporary hack to avoid looking up IDs
-            //        which for metadata that is not emitted
-            continue;
-#if 0
-            if(B.Type.id == SymbolID::zero ||
-                ! corpus_.find(B.Type.id))
+            auto base = findBase(B, corpus);
+            if(! base)
                 continue;
-            append(actualAccess,
-                corpus_.get<RecordInfo>(B.Type.id));
-#endif
+            if(auto M = getBase(*base))
+                bases.push_back({ B.Access, M });
         }
+        appendMembers(From, corpus, includePrivate);
+    }
 
+    /*  Append the entries of one table, for the
+        record and each of its bases, with the
+        access seen through `access`.
+
+        Members which would not be listed are
+        skipped. Since access only becomes more
+        restrictive along a path, this removes the
+        same members as filtering at every level.
+    */
+    template<class T>
+    void
+    collect(
+        Table<T> InterfaceMembers::* table,
+        Table<T>& dest,
+        AccessKind access,
+        bool includePrivate) const
+    {
+        for(auto const& B : bases)
+            B.members->collect(table, dest,
+                effectiveAccess(access, B.access), includePrivate);
+        for(auto const& e : this->*table)
+        {
+            auto actualAccess = effectiveAccess(access, e.access);
+            if( includePrivate ||
+                actualAccess != AccessKind::Private ||
+                e.overridable)
+                dest.push_back({ actualAccess, e.I, e.overridable });
+        }
+    }
+
+private:
+    void
+    appendMembers(
+        RecordInfo const& From,
+        Corpus const& corpus,
+        bool includePrivate)
+    {
         for(auto const& id : From.Members)
         {
-            const auto& I = corpus_.get<Info>(id);
-            auto actualAccess = effectiveAccess(access, I.Access);
+            const auto& I = corpus.get<Info>(id);
+            auto actualAccess = I.Access;
             if(I.Kind == InfoKind::Function)
             {
                 const auto& F = static_cast<FunctionInfo const&>(I);
-                auto const isRecFinal = From.specs.isFinal.get();
-                if( includePrivate_ ||
-                    actualAccess != AccessKind::Private || (
-                        ! isRecFinal && F.specs0.isVirtual))
+                bool const overridable =
+                    ! From.specs.isFinal.get() &&
+                    F.specs0.isVirtual.get();
+                if( includePrivate ||
+                    actualAccess != AccessKind::Private ||
+                    overridable)
                 {
                     if(F.specs0.storageClass == StorageClassKind::Static)
-                        staticfuncs_.push_back({ actualAccess, &F });
+                        staticfuncs.push_back({ actualAccess, &F, overridable });
                     else
-                        functions_.push_back({ actualAccess, &F });
+                        functions.push_back({ actualAccess, &F, overridable });
                 }
                 continue;
             }
-            else if(! includePrivate_ &&
+            else if(! includePrivate &&
                 actualAccess == AccessKind::Private)
             {
                 continue;
@@ -127,23 +206,23 @@ private:
             switch(I.Kind)
             {
             case InfoKind::Enum:
-                enums_.push_back({ actualAccess,
+                enums.push_back({ actualAccess,
                     static_cast<const EnumInfo*>(&I) });
                 break;
             case InfoKind::Field:
-                data_.push_back({ actualAccess,
+                data.push_back({ actualAccess,
                     static_cast<const FieldInfo*>(&I) });
                 break;
             case InfoKind::Record:
-                records_.push_back({ actualAccess,
+                records.push_back({ actualAccess,
                     static_cast<const RecordInfo*>(&I) });
                 break;
             case InfoKind::Typedef:
-                types_.push_back({ actualAccess,
+                types.push_back({ actualAccess,
                     static_cast<const TypedefInfo*>(&I) });
                 break;
             case InfoKind::Variable:
-                staticdata_.push_back({ actualAccess,
+                staticdata.push_back({ actualAccess,
                     static_cast<const VariableInfo*>(&I) });
                 break;
             default:
@@ -151,70 +230,85 @@ private:
             }
         }
     }
+};
+
+//------------------------------------------------
+
+class Interface::Build
+{
+    Interface& I_;
+
+    template<class T>
+    using Table = InterfaceMembers::Table<T>;
+
+public:
+    Build(
+        Interface& I,
+        InterfaceMembers const& M)
+        : I_(I)
+    {
+        bool const includePrivate =
+            I_.corpus.config->includePrivate;
+        auto const build = [&]<class T, class U>(
+            std::span<T const*> Interface::Tranche::*member,
+            std::vector<T const*>& dest,
+            Table<U> InterfaceMembers::* table)
+        {
+            Table<U> src;
+            M.collect(table, src, AccessKind::Public, includePrivate);
+            sort(member, dest, std::move(src));
+        };
+        build(&Interface::Tranche::Records,          I_.records_,    &InterfaceMembers::records);
+        build(&Interface::Tranche::Functions,        I_.functions_,  &InterfaceMembers::functions);
+        build(&Interface::Tranche::Enums,            I_.enums_,      &InterfaceMembers::enums);
+        build(&Interface::Tranche::Types,            I_.types_,      &InterfaceMembers::types);
+        build(&Interface::Tranche::Data,             I_.data_,       &InterfaceMembers::data);
+        build(&Interface::Tranche::StaticFunctions,  I_.staticfuncs_,&InterfaceMembers::staticfuncs);
+        build(&Interface::Tranche::StaticData,       I_.staticdata_, &InterfaceMembers::staticdata);
+    }
 
+private:
     template<class T, class U>
     void
     sort(
         std::span<T const*> Interface::Tranche::*member,
         std::vector<T const*>& dest,
-        Table<U>& src)
+        Table<U> src)
     {
         std::ranges::stable_sort(
             src,
-            []( auto const& p0,
-                auto const& p1) noexcept
+            []( auto const& e0,
+                auto const& e1) noexcept
             {
                 return
-                    to_underlying(p0.first) <
-                    to_underlying(p1.first);
+                    to_underlying(e0.access) <
+                    to_underlying(e1.access);
             });
         dest.resize(0);
         dest.reserve(src.size());
         for(auto const& v : src)
-            dest.push_back(v.second);
+            dest.push_back(v.I);
 
         auto it0 = src.begin();
         auto it = std::find_if_not(
             it0, src.end(),
-            [](auto const& p) noexcept
+            [](auto const& e) noexcept
             {
-                return p.first == AccessKind::Public;
+                return e.access == AccessKind::Public;
             });
         std::size_t const nPublic = it - it0;
         it0 = it;
         it = std::find_if_not(
             it0, src.end(),
-            [](auto const& p) noexcept
+            [](auto const& e) noexcept
             {
-                return p.first == AccessKind::Protected;
+                return e.access == AccessKind::Protected;
             });
         std::size_t const nPrivate = src.end() - it;
-//MRDOX_ASSERT(nPrivate == 0);
         I_.Public.*member    = { dest.begin(), dest.begin() + nPublic };
         I_.Protected.*member = { dest.begin() + nPublic, dest.end() - nPrivate };
         I_.Private.*member   = { dest.end() - nPrivate, dest.end() };
     }
-
-    void
-    finish()
-    {
-        sort(&Interface::Tranche::Records,          I_.records_,    records_);
-        sort(&Interface::Tranche::Functions,        I_.functions_,  functions_);
-        sort(&Interface::Tranche::Enums,            I_.enums_,      enums_);
-        sort(&Interface::Tranche::Types,            I_.types_,      types_);
-        sort(&Interface::Tranche::Data,             I_.data_,       data_);
-        sort(&Interface::Tranche::StaticFunctions,  I_.staticfuncs_,staticfuncs_);
-        sort(&Interface::Tranche::StaticData,       I_.staticdata_, staticdata_);
-#if 0
-MRDOX_ASSERT(I_.Private.Records.empty());
-MRDOX_ASSERT(I_.Private.Functions.empty());
-MRDOX_ASSERT(I_.Private.Enums.empty());
-MRDOX_ASSERT(I_.Private.Types.empty());
-MRDOX_ASSERT(I_.Private.Data.empty());
-MRDOX_ASSERT(I_.Private.StaticFunctions.empty());
-MRDOX_ASSERT(I_.Private.StaticData.empty());
-#endif
-    }
 };
 
 Interface::
@@ -229,10 +323,157 @@ makeInterface(
     RecordInfo const& Derived,
     Corpus const& corpus)
 {
+    // Each base is flattened once, even when it is
+    // reached along more than one path. A base which
+    // is still being flattened is part of a cycle,
+    // and contributes no members.
+    llvm::DenseMap<RecordInfo const*,
+        std::unique_ptr<InterfaceMembers>> memo;
+    auto flatten = [&](
+        auto& self,
+        RecordInfo const& R) -> InterfaceMembers const*
+    {
+        if(! memo.try_emplace(&R).second)
+            return memo[&R].get();
+        auto M = std::make_unique<InterfaceMembers>();
+        M->build(R, corpus,
+            [&](RecordInfo const& B)
+            {
+                return self(self, B);
+            });
+        return (memo[&R] = std::move(M)).get();
+    };
     Interface I(corpus);
-    Interface::Build(I, Derived, corpus);
+    Interface::Build(I, *flatten(flatten, Derived));
     return I;
 }
 
+//------------------------------------------------
+//
+// InterfaceCache
+//
+//------------------------------------------------
+
+InterfaceCache::
+InterfaceCache(
+    Corpus const& corpus) noexcept
+    : corpus_(corpus)
+{
+}
+
+InterfaceCache::
+~InterfaceCache() = default;
+
+void
+InterfaceCache::
+computeLevel(
+    std::uint32_t i,
+    std::vector<std::uint8_t>& state)
+{
+    // A record is one level above its deepest base.
+    // A base which is still being visited is part of
+    // a cycle, and ends up at a level which is not
+    // below this record, so it contributes nothing.
+    state[i] = 1;
+    std::uint32_t level = 0;
+    for(auto const& B : records_[i]->Bases)
+    {
+        auto base = findBase(B, corpus_);
+        if(! base)
+            continue;
+        auto it = pos_.find(base);
+        if(it == pos_.end())
+            continue;
+        auto const j = it->second;
+        if(state[j] == 1)
+            continue;
+        if(state[j] == 0)
+            computeLevel(j, state);
+        level = std::max(level, level_[j] + 1);
+    }
+    level_[i] = level;
+    state[i] = 2;
+}
+
+Error
+InterfaceCache::
+build(
+    std::vector<Info const*> const& index,
+    ThreadPool& threadPool)
+{
+    records_.clear();
+    pos_.clear();
+    for(Info const* I : index)
+    {
+        if(! I->isRecord())
+            continue;
+        pos_.try_emplace(static_cast<RecordInfo const*>(I),
+            static_cast<std::uint32_t>(records_.size()));
+        records_.push_back(static_cast<RecordInfo const*>(I));
+    }
+    std::size_t const n = records_.size();
+    level_.assign(n, 0);
+    members_.clear();
+    members_.resize(n);
+
+    std::vector<std::uint8_t> state(n, 0);
+    std::uint32_t maxLevel = 0;
+    for(std::uint32_t i = 0; i < n; ++i)
+    {
+        if(state[i] == 0)
+            computeLevel(i, state);
+        maxLevel = std::max(maxLevel, level_[i]);
+    }
+    std::vector<std::vector<std::uint32_t>> levels(maxLevel + 1);
+    for(std::uint32_t i = 0; i < n; ++i)
+        levels[level_[i]].push_back(i);
+
+    // The records on a level only use the
+    // members of records on lower levels.
+    for(auto const& list : levels)
+    {
+        std::size_t const chunk = std::max<std::size_t>(64,
+            list.size() / (threadPool.getThreadCount() * 4 + 1));
+        TaskGroup taskGroup(threadPool);
+        for(std::size_t first = 0; first < list.size(); first += chunk)
+        {
+            taskGroup.async(
+                [&, first]
+                {
+                    std::size_t const last = std::min(first + chunk, list.size());
+                    for(std::size_t k = first; k < last; ++k)
+                    {
+                        auto const i = list[k];
+                        members_[i].build(*records_[i], corpus_,
+                            [&](RecordInfo const& B) -> InterfaceMembers const*
+                            {
+                                auto it = pos_.find(&B);
+                                if( it == pos_.end() ||
+                                    level_[it->second] >= level_[i])
+                                    return nullptr;
+                                return &members_[it->second];
+                            });
+                    }
+                });
+        }
+        auto errors = taskGroup.wait();
+        if(! errors.empty())
+            return Error(errors);
+    }
+    return Error::success();
+}
+
+Interface
+InterfaceCache::
+makeInterface(
+    RecordInfo const& I) const
+{
+    auto it = pos_.find(&I);
+    MRDOX_ASSERT(it != pos_.end());
+    Interface J(corpus_);
+    Interface::Build(J, members_[it->second]);
+    return J;
+}
+
 } // mrdox
 } // clang
@@ -0,0 +1,84 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#ifndef MRDOX_LIB_METADATA_INTERFACE_HPP
+#define MRDOX_LIB_METADATA_INTERFACE_HPP
+
+#include <mrdox/Corpus.hpp>
+#include <mrdox/Metadata/Interface.hpp>
+#include <mrdox/Support/Error.hpp>
+#include <mrdox/Support/ThreadPool.hpp>
+#include <llvm/ADT/DenseMap.h>
+#include <cstdint>
+#include <vector>
+
+namespace clang {
+namespace mrdox {
+
+struct InterfaceMembers;
+
+/** The members of every record, including inherited members.
+
+    The members of each record are computed once
+    from its own members and the cached members of
+    its bases, so a hierarchy is flattened in time
+    proportional to its size.
+
+    A base which is not in the corpus, or which
+    is not a record, contributes no members.
+*/
+class InterfaceCache
+{
+    Corpus const& corpus_;
+    std::vector<RecordInfo const*> records_;
+    llvm::DenseMap<RecordInfo const*, std::uint32_t> pos_;
+    std::vector<std::uint32_t> level_;
+    std::vector<InterfaceMembers> members_;
+
+public:
+    explicit
+    InterfaceCache(
+        Corpus const& corpus) noexcept;
+
+    ~InterfaceCache();
+
+    /** Compute the members of every record in the index.
+
+        The records are grouped by their depth in
+        the hierarchy, so that the members of each
+        base are computed before the members of the
+        records which derive from it. The records
+        in a group are computed in parallel.
+    */
+    Error
+    build(
+        std::vector<Info const*> const& index,
+        ThreadPool& threadPool);
+
+    /** Return the interface of a record.
+
+        The record must have been in the
+        index passed to @ref build.
+    */
+    Interface
+    makeInterface(
+        RecordInfo const& I) const;
+
+private:
+    void
+    computeLevel(
+        std::uint32_t i,
+        std::vector<std::uint8_t>& state);
+};
+
+} // mrdox
+} // clang
+
+#endif
@@ -14,13 +14,85 @@
 #include <mrdox/Metadata/Javadoc.hpp>
 #include <llvm/Support/Error.h>
 #include <llvm/Support/Path.h>
+#include <llvm/Support/xxhash.h>
 #include <fmt/format.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <mutex>
 
 namespace clang {
 namespace mrdox {
 
 namespace doc {
 
+Arena::
+Arena(Arena&& other) noexcept
+    : chunks_(std::move(other.chunks_))
+    , pos_(std::exchange(other.pos_, nullptr))
+    , avail_(std::exchange(other.avail_, 0))
+    , next_(std::exchange(other.next_, 0))
+{
+}
+
+Arena&
+Arena::
+operator=(Arena&& other) noexcept
+{
+    chunks_ = std::move(other.chunks_);
+    pos_ = std::exchange(other.pos_, nullptr);
+    avail_ = std::exchange(other.avail_, 0);
+    next_ = std::exchange(other.next_, 0);
+    return *this;
+}
+
+void*
+Arena::
+allocate(
+    std::size_t size,
+    std::size_t align)
+{
+    // Most javadocs are small, so start with a
+    // modest chunk and grow geometrically.
+    constexpr std::size_t minChunk = 512;
+    constexpr std::size_t maxChunk = 16384;
+
+    auto pad = reinterpret_cast<std::uintptr_t>(
+        pos_) & (align - 1);
+    if(pad != 0)
+        pad = align - pad;
+    if(pos_ == nullptr || pad + size > avail_)
+    {
+        next_ = std::clamp(next_ * 2, minChunk, maxChunk);
+        // align <= alignof(std::max_align_t)
+        // for every node type
+        auto n = std::max(next_, size);
+        chunks_.emplace_back(new std::byte[n]);
+        pos_ = chunks_.back().get();
+        avail_ = n;
+        pad = 0;
+    }
+    void* p = pos_ + pad;
+    pos_ += pad + size;
+    avail_ -= pad + size;
+    return p;
+}
+
+void
+Arena::
+adopt(Arena&& other)
+{
+    chunks_.reserve(chunks_.size() + other.chunks_.size());
+    for(auto& chunk : other.chunks_)
+        chunks_.emplace_back(std::move(chunk));
+    other.chunks_.clear();
+    other.pos_ = nullptr;
+    other.avail_ = 0;
+    other.next_ = 0;
+}
+
+//------------------------------------------------
+
 bool
 Node::
 isBlock() const noexcept
@@ -78,7 +150,7 @@ isText() const noexcept
 void
 Block::
 emplace_back(
-    std::unique_ptr<Text> text)
+    Pointer<Text> text)
 {
     MRDOX_ASSERT(text->isText());
     children.emplace_back(std::move(text));
@@ -92,7 +164,7 @@ append(List<Node>&& blocks)
     for(auto&& block : blocks)
     {
         MRDOX_ASSERT(block->isText());
-        emplace_back(std::unique_ptr<Text>(
+        emplace_back(Pointer<Text>(
             static_cast<Text*>(block.release())));
     }
 }
@@ -183,22 +255,115 @@ move_to(
     return it;
 }
 
+namespace {
+
+// Combine the hashes of two comments. This
+// is order-dependent, like appending blocks.
+std::uint64_t
+combineHash(
+    std::uint64_t h0,
+    std::uint64_t h1) noexcept
+{
+    return h0 ^ (h1 + 0x9e3779b97f4a7c15ULL +
+        (h0 << 6) + (h0 >> 2));
+}
+
+doc::Pointer<doc::Node>
+cloneNode(
+    doc::Arena& arena,
+    doc::Node const& node)
+{
+    return doc::visit(node,
+        [&]<class T>(T const& J) -> doc::Pointer<doc::Node>
+        {
+            auto N = arena.create<T>();
+            if constexpr(requires { J.href; })
+                N->href = J.href;
+            if constexpr(requires { J.string; })
+                N->string = J.string;
+            if constexpr(requires { J.style; })
+                N->style = J.style;
+            if constexpr(requires { J.admonish; })
+                N->admonish = J.admonish;
+            if constexpr(requires { J.direction; })
+                N->direction = J.direction;
+            if constexpr(requires { J.name; })
+                N->name = J.name;
+            if constexpr(requires { J.children; })
+            {
+                N->children.reserve(J.children.size());
+                for(auto const& child : J.children)
+                    N->children.emplace_back(
+                        static_cast<doc::Text*>(cloneNode(
+                            arena, *child).release()));
+            }
+            return N;
+        });
+}
+
+} // (anon)
+
 //------------------------------------------------
 
+struct Javadoc::Pending
+{
+    std::mutex mutex;
+    std::atomic<bool> done = false;
+    std::vector<doc::RawText> raw;
+    Parser parser = nullptr;
+};
+
 Javadoc::
 Javadoc() noexcept = default;
 
+Javadoc::
+~Javadoc() = default;
+
 Javadoc::
 Javadoc(
+    doc::Arena arena,
     doc::List<doc::Block> blocks)
-    : blocks_(std::move(blocks))
+    : arena_(std::move(arena))
+    , blocks_(std::move(blocks))
 {
 }
 
+Javadoc::
+Javadoc(
+    std::shared_ptr<Javadoc const> shared) noexcept
+    : shared_(std::move(shared))
+{
+    if(shared_ && shared_->shared_)
+        shared_ = shared_->shared_;
+    MRDOX_ASSERT(! shared_ || ! shared_->pending_);
+}
+
+Javadoc::
+Javadoc(Javadoc&&) noexcept = default;
+
+Javadoc&
+Javadoc::
+operator=(Javadoc&& other) noexcept
+{
+    // destroy our nodes before their storage
+    blocks_.clear();
+    arena_ = std::move(other.arena_);
+    hash_ = std::exchange(other.hash_, 0);
+    brief_ = std::exchange(other.brief_, nullptr);
+    blocks_ = std::move(other.blocks_);
+    pending_ = std::move(other.pending_);
+    shared_ = std::move(other.shared_);
+    return *this;
+}
+
 doc::Paragraph const*
 Javadoc::
-brief() const noexcept
+brief() const
 {
+    if(shared_)
+        return shared_->brief();
+    if(pending_)
+        parsePending();
     if(brief_)
         return brief_;
     for(auto const& block : blocks_)
@@ -211,8 +376,52 @@ brief() const noexcept
 bool
 Javadoc::
 operator==(
-    Javadoc const& other) const noexcept
+    Javadoc const& other) const
 {
+    if(this == &other)
+        return true;
+    if(shared_ && shared_ == other.shared_)
+        return true;
+    if(shared_)
+        return *shared_ == other;
+    if(other.shared_)
+        return *this == *other.shared_;
+    // Comments which are both still unparsed
+    // are compared by their text, without
+    // parsing them.
+    {
+        std::unique_lock<std::mutex> lock;
+        std::unique_lock<std::mutex> otherLock;
+        if(pending_)
+            lock = std::unique_lock<std::mutex>(
+                pending_->mutex, std::defer_lock);
+        if(other.pending_)
+            otherLock = std::unique_lock<std::mutex>(
+                other.pending_->mutex, std::defer_lock);
+        if(lock.mutex() && otherLock.mutex())
+            std::lock(lock, otherLock);
+        else if(lock.mutex())
+            lock.lock();
+        else if(otherLock.mutex())
+            otherLock.lock();
+        bool const pending =
+            pending_ && ! pending_->done;
+        bool const otherPending =
+            other.pending_ && ! other.pending_->done;
+        if( pending && otherPending &&
+            blocks_.empty() && other.blocks_.empty() &&
+            pending_->raw == other.pending_->raw)
+            return true;
+    }
+    // Otherwise the parsed nodes are compared,
+    // so that a comment which is still pending
+    // equals the same comment already parsed.
+    auto const& blocks = getBlocks();
+    auto const& otherBlocks = other.getBlocks();
+    // javadocs parsed from the same
+    // comments have the same nodes
+    if(hash_ != 0 && hash_ == other.hash_)
+        return true;
     if(! brief_ || ! other.brief_)
     {
         if(brief_ != other.brief_)
@@ -222,8 +431,8 @@ operator==(
     {
         return false;
     }
-    return std::equal(blocks_.begin(), blocks_.end(),
-        other.blocks_.begin(), other.blocks_.end(),
+    return std::equal(blocks.begin(), blocks.end(),
+        otherBlocks.begin(), otherBlocks.end(),
         [](const auto& a, const auto& b)
         {
             return a->equals(static_cast<const doc::Node&>(*b));
@@ -233,7 +442,7 @@ operator==(
 bool
 Javadoc::
 operator!=(
-    Javadoc const& other) const noexcept
+    Javadoc const& other) const
 {
     return !(*this == other);
 }
@@ -242,13 +451,47 @@ doc::Overview
 Javadoc::
 makeOverview() const
 {
-    return doc::makeOverview(blocks_);
+    return doc::makeOverview(getBlocks());
+}
+
+Javadoc
+Javadoc::
+clone() const
+{
+    if(shared_)
+        return Javadoc(shared_);
+    Javadoc jd;
+    jd.hash_ = hash_;
+    jd.blocks_.reserve(blocks_.size());
+    for(auto const& block : blocks_)
+    {
+        auto p = static_cast<doc::Block*>(
+            cloneNode(jd.arena_, *block).release());
+        if(block.get() == brief_)
+            jd.brief_ = static_cast<doc::Paragraph const*>(p);
+        jd.blocks_.emplace_back(p);
+    }
+    for(auto& raw : getPending())
+        jd.appendRaw(std::move(raw), pending_->parser);
+    return jd;
+}
+
+std::vector<doc::RawText>
+Javadoc::
+getPending() const
+{
+    if(! pending_)
+        return {};
+    std::lock_guard<std::mutex> lock(pending_->mutex);
+    if(pending_->done)
+        return {};
+    return pending_->raw;
 }
 
 std::string
 Javadoc::
 emplace_back(
-    std::unique_ptr<doc::Block> block)
+    doc::Pointer<doc::Block> block)
 {
     MRDOX_ASSERT(block->isBlock());
 
@@ -316,16 +559,35 @@ Javadoc::
 append(
     Javadoc&& other)
 {
+    unshare();
+    other.unshare();
+    if(! other.blocks_.empty())
+    {
+        if(blocks_.empty())
+            hash_ = other.hash_;
+        else if(hash_ != 0 && other.hash_ != 0)
+            hash_ = combineHash(hash_, other.hash_);
+        else
+            hash_ = 0;
+    }
+    arena_.adopt(std::move(other.arena_));
     // VFALCO What about the returned strings,
     // for warnings and errors?
     for(auto&& block : other.blocks_)
         emplace_back(std::move(block));
+    other.blocks_.clear();
+    other.brief_ = nullptr;
+    if(other.pending_ && ! other.pending_->done)
+        for(auto& raw : other.pending_->raw)
+            appendRaw(std::move(raw), other.pending_->parser);
+    other.pending_.reset();
 }
 
 void
 Javadoc::
 append(doc::List<doc::Node>&& blocks)
 {
+    unshare();
     blocks_.reserve(blocks_.size() + blocks.size());
     for(auto&& block : blocks)
     {
@@ -335,5 +597,75 @@ append(doc::List<doc::Node>&& blocks)
     }
 }
 
+void
+Javadoc::
+appendRaw(
+    std::string text,
+    Parser parser)
+{
+    auto const hash = llvm::xxHash64(text);
+    appendRaw(doc::RawText{ std::move(text), hash }, parser);
+}
+
+void
+Javadoc::
+appendRaw(
+    doc::RawText raw,
+    Parser parser)
+{
+    MRDOX_ASSERT(parser);
+    unshare();
+    if(! pending_)
+        pending_ = std::make_unique<Pending>();
+    if(! pending_->parser)
+        pending_->parser = parser;
+    for(auto const& other : pending_->raw)
+        if(other == raw)
+            return;
+    pending_->raw.emplace_back(std::move(raw));
+    pending_->done = false;
+}
+
+void
+Javadoc::
+parsePending() const
+{
+    if(pending_->done.load(std::memory_order_acquire))
+        return;
+    std::lock_guard<std::mutex> lock(pending_->mutex);
+    if(pending_->done.load(std::memory_order_relaxed))
+        return;
+    // The parsed blocks are appended exactly once, and
+    // readers do not look at them until `done` is set.
+    auto& self = const_cast<Javadoc&>(*this);
+    for(auto const& raw : pending_->raw)
+    {
+        Javadoc jd = pending_->parser(raw);
+        jd.unshare();
+        if(jd.blocks_.empty())
+            continue;
+        if(self.blocks_.empty())
+            self.hash_ = jd.hash_;
+        else if(self.hash_ != 0)
+            self.hash_ = combineHash(self.hash_, jd.hash_);
+        self.arena_.adopt(std::move(jd.arena_));
+        for(auto&& block : jd.blocks_)
+            self.emplace_back(std::move(block));
+        jd.blocks_.clear();
+    }
+    pending_->raw.clear();
+    pending_->done.store(true, std::memory_order_release);
+}
+
+void
+Javadoc::
+unshare()
+{
+    if(! shared_)
+        return;
+    auto shared = std::move(shared_);
+    *this = shared->clone();
+}
+
 } // mrdox
 } // clang
@@ -0,0 +1,461 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#include "lib/Support/Compression.hpp"
+#include "lib/Support/Error.hpp"
+#include <llvm/ADT/ArrayRef.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/CRC.h>
+#include <llvm/Support/Compression.h>
+#include <llvm/Support/Endian.h>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <mutex>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+namespace clang {
+namespace mrdox {
+
+namespace {
+
+namespace endian = llvm::support::endian;
+
+// The amount of text compressed at once
+constexpr std::size_t blockSize = 1024 * 1024;
+
+// The number of blocks in the ring
+constexpr std::size_t ringSize = 4;
+
+/*  A gzip member is written with an extra field
+    holding the size of the deflate data and the
+    checksum of the zlib stream it came from, so
+    that the reader can rebuild the zlib stream
+    which LLVM decompresses. Other tools ignore
+    the extra field.
+*/
+constexpr std::uint8_t gzipHeader[] = {
+    0x1f, 0x8b,             // ID1, ID2
+    8,                      // CM: deflate
+    4,                      // FLG: FEXTRA
+    0, 0, 0, 0,             // MTIME
+    0,                      // XFL
+    255,                    // OS: unknown
+    12, 0,                  // XLEN
+    'M', 'D', 8, 0 };       // subfield and its length
+
+constexpr std::size_t gzipHeaderSize = sizeof(gzipHeader) + 8;
+
+// A zlib stream without a preset dictionary
+// has a two byte header and a four byte checksum.
+constexpr std::uint8_t zlibHeader[] = { 0x78, 0x9c };
+
+constexpr std::uint32_t zstdMagic = 0xFD2FB528;
+
+// Append a block to the output as a gzip member
+void
+putGzip(
+    llvm::SmallVectorImpl<std::uint8_t>& out,
+    llvm::ArrayRef<std::uint8_t> text)
+{
+    llvm::SmallVector<std::uint8_t, 0> zlib;
+    llvm::compression::zlib::compress(text, zlib);
+    auto deflate = llvm::ArrayRef<std::uint8_t>(zlib).slice(
+        sizeof(zlibHeader), zlib.size() - sizeof(zlibHeader) - 4);
+
+    std::uint8_t buf[8];
+    out.append(std::begin(gzipHeader), std::end(gzipHeader));
+    endian::write32le(buf, static_cast<std::uint32_t>(deflate.size()));
+    std::memcpy(buf + 4, zlib.data() + zlib.size() - 4, 4);
+    out.append(buf, buf + 8);
+    out.append(deflate.begin(), deflate.end());
+    endian::write32le(buf, llvm::crc32(text));
+    endian::write32le(buf + 4, static_cast<std::uint32_t>(text.size()));
+    out.append(buf, buf + 8);
+}
+
+Error
+getGzip(
+    std::string& out,
+    llvm::ArrayRef<std::uint8_t> data)
+{
+    llvm::SmallVector<std::uint8_t, 0> zlib;
+    while(! data.empty())
+    {
+        if(data.size() < gzipHeaderSize + 8 ||
+            std::memcmp(data.data(), gzipHeader, sizeof(gzipHeader)) != 0)
+            return formatError("the gzip data was not written by mrdox");
+        auto const size = endian::read32le(data.data() + sizeof(gzipHeader));
+        if(size > data.size() - gzipHeaderSize - 8)
+            return formatError("the gzip data is truncated");
+        auto deflate = data.slice(gzipHeaderSize, size);
+        auto trailer = data.data() + gzipHeaderSize + size;
+        auto const crc = endian::read32le(trailer);
+        std::size_t textSize = endian::read32le(trailer + 4);
+
+        zlib.assign(std::begin(zlibHeader), std::end(zlibHeader));
+        zlib.append(deflate.begin(), deflate.end());
+        zlib.append(
+            data.data() + sizeof(gzipHeader) + 4,
+            data.data() + sizeof(gzipHeader) + 8);
+        auto const pos = out.size();
+        out.resize(pos + textSize);
+        auto text = reinterpret_cast<std::uint8_t*>(out.data() + pos);
+        if(auto err = llvm::compression::zlib::decompress(zlib, text, textSize))
+            return toError(std::move(err));
+        if(llvm::crc32(llvm::ArrayRef<std::uint8_t>(text, textSize)) != crc)
+            return formatError("the gzip data is corrupt");
+        data = data.drop_front(gzipHeaderSize + size + 8);
+    }
+    return Error::success();
+}
+
+/*  Return the size of the zstd frame at the front
+    of the data, and the size of its content. The
+    frame must record the size of its content,
+    which frames written by mrdox always do.
+*/
+Error
+getZstdFrame(
+    llvm::ArrayRef<std::uint8_t> data,
+    std::size_t& frameSize,
+    std::size_t& contentSize)
+{
+    auto truncated = []
+    {
+        return formatError("the zstd data is truncated");
+    };
+    if(data.size() < 5 || endian::read32le(data.data()) != zstdMagic)
+        return formatError("the zstd data was not written by mrdox");
+    std::uint8_t const fhd = data[4];
+    unsigned const fcsFlag = fhd >> 6;
+    bool const singleSegment = (fhd >> 5) & 1;
+    bool const checksum = (fhd >> 2) & 1;
+    constexpr std::size_t dictSizes[] = { 0, 1, 2, 4 };
+    constexpr std::size_t fcsSizes[] = { 0, 2, 4, 8 };
+    std::size_t const fcsSize = fcsFlag == 0 && singleSegment ? 1 : fcsSizes[fcsFlag];
+    if(fcsSize == 0)
+        return formatError("the zstd data was not written by mrdox");
+
+    std::size_t pos = 5 + (singleSegment ? 0 : 1) + dictSizes[fhd & 3];
+    if(data.size() < pos + fcsSize)
+        return truncated();
+    std::uint8_t const* p = data.data() + pos;
+    switch(fcsSize)
+    {
+    case 1: contentSize = p[0]; break;
+    case 2: contentSize = endian::read16le(p) + 256u; break;
+    case 4: contentSize = endian::read32le(p); break;
+    default: contentSize = endian::read64le(p); break;
+    }
+    pos += fcsSize;
+
+    // Skip the blocks
+    for(;;)
+    {
+        if(data.size() < pos + 3)
+            return truncated();
+        std::uint32_t const header = data[pos] |
+            (data[pos + 1] << 8) | (data[pos + 2] << 16);
+        std::size_t const size = header >> 3;
+        unsigned const type = (header >> 1) & 3;
+        if(type == 3)
+            return formatError("the zstd data is corrupt");
+        pos += 3 + (type == 1 ? 1 : size);
+        if(header & 1)
+            break;
+    }
+    if(checksum)
+        pos += 4;
+    if(data.size() < pos)
+        return truncated();
+    frameSize = pos;
+    return Error::success();
+}
+
+Error
+getZstd(
+    std::string& out,
+    llvm::ArrayRef<std::uint8_t> data)
+{
+    while(! data.empty())
+    {
+        std::size_t frameSize;
+        std::size_t contentSize;
+        if(auto err = getZstdFrame(data, frameSize, contentSize))
+            return err;
+        auto const pos = out.size();
+        out.resize(pos + contentSize);
+        if(auto err = llvm::compression::zstd::decompress(
+                data.take_front(frameSize),
+                reinterpret_cast<std::uint8_t*>(out.data() + pos),
+                contentSize))
+            return toError(std::move(err));
+        out.resize(pos + contentSize);
+        data = data.drop_front(frameSize);
+    }
+    return Error::success();
+}
+
+} // (anon)
+
+Compression
+getCompression(
+    std::string_view fileName) noexcept
+{
+    llvm::StringRef name(fileName.data(), fileName.size());
+    if(name.endswith_insensitive(".gz"))
+        return Compression::gzip;
+    if(name.endswith_insensitive(".zst"))
+        return Compression::zstd;
+    return Compression::none;
+}
+
+std::string_view
+stripCompression(
+    std::string_view fileName) noexcept
+{
+    switch(getCompression(fileName))
+    {
+    case Compression::gzip:
+        fileName.remove_suffix(3);
+        break;
+    case Compression::zstd:
+        fileName.remove_suffix(4);
+        break;
+    default:
+        break;
+    }
+    return fileName;
+}
+
+Error
+requireCompression(
+    Compression compression)
+{
+    char const* reason = nullptr;
+    switch(compression)
+    {
+    case Compression::gzip:
+        reason = llvm::compression::getReasonIfUnsupported(
+            llvm::compression::Format::Zlib);
+        break;
+    case Compression::zstd:
+        reason = llvm::compression::getReasonIfUnsupported(
+            llvm::compression::Format::Zstd);
+        break;
+    default:
+        break;
+    }
+    if(reason)
+        return formatError("compression is not available: {}", reason);
+    return Error::success();
+}
+
+//------------------------------------------------
+
+class CompressedOstream::Buffer
+    : public std::streambuf
+{
+    std::ostream& dest_;
+    Compression compression_;
+    std::vector<std::string> ring_;
+    std::vector<std::size_t> sizes_;
+    std::size_t current_ = 0;
+    std::mutex mutex_;
+    std::condition_variable blockFull_;
+    std::condition_variable blockFree_;
+    std::deque<std::size_t> full_;
+    std::deque<std::size_t> free_;
+    bool closed_ = false;
+    bool empty_ = true;
+    Error err_;
+    std::thread thread_;
+
+public:
+    Buffer(
+        std::ostream& dest,
+        Compression compression)
+        : dest_(dest)
+        , compression_(compression)
+        , ring_(ringSize)
+        , sizes_(ringSize)
+    {
+        for(std::size_t i = 0; i < ringSize; ++i)
+        {
+            ring_[i].resize(blockSize);
+            if(i != current_)
+                free_.push_back(i);
+        }
+        setp(ring_[current_].data(), ring_[current_].data() + blockSize);
+        thread_ = std::thread(&Buffer::run, this);
+    }
+
+    ~Buffer()
+    {
+        if(thread_.joinable())
+            close();
+    }
+
+    Error
+    close()
+    {
+        // Empty text is still written as one empty
+        // block, so that the output is not empty.
+        submit(empty_);
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            closed_ = true;
+        }
+        blockFull_.notify_one();
+        thread_.join();
+        dest_.flush();
+        if(! err_ && ! dest_)
+            err_ = formatError("could not write the compressed output");
+        return err_;
+    }
+
+private:
+    int_type
+    overflow(int_type ch) override
+    {
+        submit();
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            blockFree_.wait(lock,
+                [&]
+                {
+                    return ! free_.empty();
+                });
+            current_ = free_.front();
+            free_.pop_front();
+        }
+        setp(ring_[current_].data(), ring_[current_].data() + blockSize);
+        if(traits_type::eq_int_type(ch, traits_type::eof()))
+            return traits_type::not_eof(ch);
+        *pptr() = traits_type::to_char_type(ch);
+        pbump(1);
+        return ch;
+    }
+
+    // Hand the current block to the compressor
+    void
+    submit(bool always = false)
+    {
+        std::size_t const n = pptr() - pbase();
+        if(n == 0 && ! always)
+            return;
+        setp(nullptr, nullptr);
+        empty_ = false;
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            sizes_[current_] = n;
+            full_.push_back(current_);
+        }
+        blockFull_.notify_one();
+    }
+
+    void
+    run()
+    {
+        llvm::SmallVector<std::uint8_t, 0> out;
+        std::unique_lock<std::mutex> lock(mutex_);
+        for(;;)
+        {
+            blockFull_.wait(lock,
+                [&]
+                {
+                    return closed_ || ! full_.empty();
+                });
+            if(full_.empty())
+                return;
+            std::size_t const i = full_.front();
+            full_.pop_front();
+            bool const failed = static_cast<bool>(err_);
+            lock.unlock();
+
+            // After a failure the blocks are
+            // discarded, so the writer is not held.
+            if(! failed)
+            {
+                llvm::ArrayRef<std::uint8_t> text(
+                    reinterpret_cast<std::uint8_t const*>(
+                        ring_[i].data()), sizes_[i]);
+                out.clear();
+                if(compression_ == Compression::gzip)
+                    putGzip(out, text);
+                else
+                    llvm::compression::zstd::compress(text, out);
+                dest_.write(reinterpret_cast<char const*>(
+                    out.data()), out.size());
+            }
+
+            lock.lock();
+            if(! failed && ! dest_)
+                err_ = formatError("could not write the compressed output");
+            free_.push_back(i);
+            blockFree_.notify_one();
+        }
+    }
+};
+
+CompressedOstream::
+CompressedOstream(
+    std::ostream& dest,
+    Compression compression)
+    : std::ostream(nullptr)
+    , buf_(std::make_unique<Buffer>(dest, compression))
+{
+    rdbuf(buf_.get());
+}
+
+CompressedOstream::
+~CompressedOstream() = default;
+
+Error
+CompressedOstream::
+close()
+{
+    return buf_->close();
+}
+
+Expected<std::string>
+decompress(
+    std::string_view data,
+    Compression compression)
+{
+    llvm::ArrayRef<std::uint8_t> bytes(
+        reinterpret_cast<std::uint8_t const*>(data.data()),
+        data.size());
+    std::string out;
+    Error err;
+    switch(compression)
+    {
+    case Compression::gzip:
+        err = getGzip(out, bytes);
+        break;
+    case Compression::zstd:
+        err = getZstd(out, bytes);
+        break;
+    default:
+        out.assign(data);
+        break;
+    }
+    if(err)
+        return err;
+    return out;
+}
+
+} // mrdox
+} // clang
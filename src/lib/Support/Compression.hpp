@@ -0,0 +1,111 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#ifndef MRDOX_LIB_SUPPORT_COMPRESSION_HPP
+#define MRDOX_LIB_SUPPORT_COMPRESSION_HPP
+
+#include <mrdox/Platform.hpp>
+#include <mrdox/Support/Error.hpp>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <string_view>
+
+namespace clang {
+namespace mrdox {
+
+/** The compression applied to a file.
+*/
+enum class Compression
+{
+    none,
+    gzip,
+    zstd
+};
+
+/** Return the compression of a file from its extension.
+
+    Files ending in `.gz` use gzip, and
+    files ending in `.zst` use zstd.
+*/
+Compression
+getCompression(
+    std::string_view fileName) noexcept;
+
+/** Return the file name without its compression extension.
+*/
+std::string_view
+stripCompression(
+    std::string_view fileName) noexcept;
+
+/** Return an error if a compression is not available in this build.
+*/
+Error
+requireCompression(
+    Compression compression);
+
+/** An output stream which compresses on a separate thread.
+
+    The text written to the stream fills a ring
+    of fixed size blocks. Each full block is
+    compressed and written to the destination on
+    another thread, while the writer fills the
+    next block. The writer only waits when every
+    block is in use.
+
+    Each block becomes one gzip member or one
+    zstd frame, so the standard tools can read
+    the output. Empty text is written as one
+    empty block. Flushing the stream does not
+    end a block.
+*/
+class CompressedOstream
+    : public std::ostream
+{
+    class Buffer;
+
+    std::unique_ptr<Buffer> buf_;
+
+public:
+    /** Constructor.
+
+        @param dest The stream which receives
+        the compressed output.
+
+        @param compression The compression to
+        apply, which must be available.
+    */
+    CompressedOstream(
+        std::ostream& dest,
+        Compression compression);
+
+    /** Destructor.
+
+        The stream is closed if it is open.
+    */
+    ~CompressedOstream();
+
+    /** Compress the remaining text and wait for it to be written.
+    */
+    Error
+    close();
+};
+
+/** Return the decompressed contents of a file written by @ref CompressedOstream.
+*/
+Expected<std::string>
+decompress(
+    std::string_view data,
+    Compression compression);
+
+} // mrdox
+} // clang
+
+#endif
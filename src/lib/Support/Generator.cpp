@@ -10,17 +10,25 @@
 //
 
 #include "lib/AST/ParseJavadoc.hpp"
+#include "lib/Support/Compression.hpp"
+#include "lib/Support/Memory.hpp"
 #include <mrdox/Support/Error.hpp>
 #include <mrdox/Generator.hpp>
 #include <llvm/ADT/SmallString.h>
 #include <llvm/Support/FileSystem.h>
 #include <llvm/Support/Path.h>
+#include <fmt/format.h>
+#include <chrono>
 #include <fstream>
 #include <sstream>
+#include <thread>
 
 namespace clang {
 namespace mrdox {
 
+SymbolRenderer::
+~SymbolRenderer() noexcept = default;
+
 Generator::
 ~Generator() noexcept = default;
 
@@ -42,8 +50,10 @@ build(
     SmallString ext(".");
     ext += fileExtension();
 
+    // A compressed file is named for
+    // the extension it has inside.
     SmallString fileName(outputPath);
-    if(path::extension(outputPath).compare_insensitive(ext) != 0)
+    if(path::extension(stripCompression(outputPath)).compare_insensitive(ext) != 0)
     {
         // directory specified
         path::append(fileName, "reference");
@@ -59,6 +69,10 @@ buildOne(
     std::string_view fileName,
     Corpus const& corpus) const
 {
+    Compression const compression = getCompression(fileName);
+    if(auto err = requireCompression(compression))
+        return err;
+
     std::ofstream os;
 
     try
@@ -76,7 +90,15 @@ buildOne(
 
     try
     {
-        return buildOne(os, corpus);
+        if(compression == Compression::none)
+            return buildOne(os, corpus);
+
+        CompressedOstream cos(os, compression);
+        auto err = buildOne(cos, corpus);
+        auto closeErr = cos.close();
+        if(err)
+            return err;
+        return closeErr;
     }
     catch(std::exception const& ex)
     {
@@ -110,5 +132,71 @@ buildOneString(
     }
 }
 
+Expected<std::unique_ptr<SymbolRenderer>>
+Generator::
+makeSymbolRenderer(
+    Corpus const&) const
+{
+    return formatError("the {} generator cannot render a single symbol", id());
+}
+
+//------------------------------------------------
+
+Error
+buildAll(
+    std::vector<Generator const*> const& generators,
+    std::string_view outputPath,
+    Corpus const& corpus)
+{
+    std::vector<Error> results(generators.size());
+    auto generate = [&](std::size_t i)
+    {
+        auto const t0 = std::chrono::steady_clock::now();
+        // An exception must not escape the thread,
+        // so it becomes the result of the build.
+        try
+        {
+            results[i] = generators[i]->build(outputPath, corpus);
+        }
+        catch(Exception const& ex)
+        {
+            results[i] = ex.error();
+        }
+        catch(std::exception const& ex)
+        {
+            results[i] = Error(ex);
+        }
+        auto const ms = std::chrono::duration_cast<
+            std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - t0).count();
+        report::info("{} generated in {} ms",
+            generators[i]->displayName(), ms);
+        memoryReport().record(fmt::format(
+            "generate.{}", generators[i]->id()));
+    };
+    if(generators.size() == 1)
+    {
+        generate(0);
+    }
+    else
+    {
+        std::vector<std::thread> threads;
+        threads.reserve(generators.size());
+        for(std::size_t i = 0; i < generators.size(); ++i)
+            threads.emplace_back(generate, i);
+        for(auto& t : threads)
+            t.join();
+    }
+
+    // Only the failures are reported
+    std::vector<Error> errors;
+    for(auto& err : results)
+        if(err)
+            errors.emplace_back(std::move(err));
+    if(errors.empty())
+        return Error::success();
+    return Error(errors);
+}
+
 } // mrdox
 } // clang
@@ -0,0 +1,291 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#include "lib/Support/GeneratorHelpers.hpp"
+#include "lib/Support/Error.hpp"
+#include <mrdox/Dom.hpp>
+#include <fmt/format.h>
+#include <algorithm>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace clang {
+namespace mrdox {
+
+namespace {
+
+// Return the argument at index i, or null
+dom::Value
+arg(
+    dom::Array const& args,
+    std::size_t i)
+{
+    if(i < args.size())
+        return args.get(i);
+    return nullptr;
+}
+
+// Return true if a value converts to true in JavaScript.
+// Unlike Handlebars' #if, empty arrays and objects are true.
+bool
+isTruthyJS(
+    dom::Value const& v)
+{
+    switch(v.kind())
+    {
+    case dom::Kind::Null:
+        return false;
+    case dom::Kind::Boolean:
+        return v.getBool();
+    case dom::Kind::Integer:
+        return v.getInteger() != 0;
+    case dom::Kind::String:
+        return ! v.getString().empty();
+    case dom::Kind::Array:
+    case dom::Kind::Object:
+    case dom::Kind::Function:
+        return true;
+    default:
+        MRDOX_UNREACHABLE();
+    }
+}
+
+// Return the result of a === b
+bool
+isStrictEqual(
+    dom::Value const& a,
+    dom::Value const& b)
+{
+    if(a.kind() != b.kind())
+        return false;
+    switch(a.kind())
+    {
+    case dom::Kind::Null:
+        return true;
+    case dom::Kind::Boolean:
+        return a.getBool() == b.getBool();
+    case dom::Kind::Integer:
+        return a.getInteger() == b.getInteger();
+    case dom::Kind::String:
+        return a.getString() == b.getString();
+    case dom::Kind::Array:
+        return a.getArray().impl() == b.getArray().impl();
+    case dom::Kind::Object:
+        return a.getObject().impl() == b.getObject().impl();
+    case dom::Kind::Function:
+        return false;
+    default:
+        MRDOX_UNREACHABLE();
+    }
+}
+
+// Append v as JSON.stringify(v, null, 2) does.
+// Functions are skipped in objects and written
+// as null in arrays, and a value which contains
+// itself throws, as in JavaScript.
+void
+stringifyJS(
+    std::string& dest,
+    dom::Value const& v,
+    std::vector<void const*>& path)
+{
+    auto const newline = [&]
+    {
+        dest.push_back('\n');
+        dest.append(2 * path.size(), ' ');
+    };
+    auto const enter = [&](void const* p)
+    {
+        if(std::find(path.begin(), path.end(), p) != path.end())
+            throw std::runtime_error(
+                "Converting circular structure to JSON");
+        path.push_back(p);
+    };
+
+    switch(v.kind())
+    {
+    case dom::Kind::Null:
+    case dom::Kind::Function:
+        dest.append("null");
+        return;
+    case dom::Kind::Boolean:
+        dest.append(v.getBool() ? "true" : "false");
+        return;
+    case dom::Kind::Integer:
+        dest.append(std::to_string(v.getInteger()));
+        return;
+    case dom::Kind::String:
+    {
+        dest.push_back('"');
+        for(char c : v.getString().get())
+        {
+            switch(c)
+            {
+            case '"':  dest.append("\\\""); break;
+            case '\\': dest.append("\\\\"); break;
+            case '\b': dest.append("\\b"); break;
+            case '\f': dest.append("\\f"); break;
+            case '\n': dest.append("\\n"); break;
+            case '\r': dest.append("\\r"); break;
+            case '\t': dest.append("\\t"); break;
+            default:
+                if(static_cast<unsigned char>(c) < 0x20)
+                    dest.append(fmt::format("\\u{:04x}",
+                        static_cast<unsigned>(c)));
+                else
+                    dest.push_back(c);
+                break;
+            }
+        }
+        dest.push_back('"');
+        return;
+    }
+    case dom::Kind::Array:
+    {
+        auto const& arr = v.getArray();
+        if(arr.size() == 0)
+        {
+            dest.append("[]");
+            return;
+        }
+        enter(arr.impl().get());
+        dest.push_back('[');
+        for(std::size_t i = 0; i < arr.size(); ++i)
+        {
+            if(i != 0)
+                dest.push_back(',');
+            newline();
+            stringifyJS(dest, arr.get(i), path);
+        }
+        path.pop_back();
+        newline();
+        dest.push_back(']');
+        return;
+    }
+    case dom::Kind::Object:
+    {
+        auto const& obj = v.getObject();
+        enter(obj.impl().get());
+        bool first = true;
+        for(auto const& kv : obj)
+        {
+            if(kv.value.isFunction())
+                continue;
+            dest.push_back(first ? '{' : ',');
+            first = false;
+            newline();
+            stringifyJS(dest, kv.key, path);
+            dest.append(": ");
+            stringifyJS(dest, kv.value, path);
+        }
+        path.pop_back();
+        if(first)
+        {
+            dest.append("{}");
+            return;
+        }
+        newline();
+        dest.push_back('}');
+        return;
+    }
+    default:
+        MRDOX_UNREACHABLE();
+    }
+}
+
+} // (anon)
+
+void
+registerGeneratorHelpers(
+    Handlebars& hbs,
+    Config const& config)
+{
+    bool const multiPage = config->multiPage;
+    hbs.registerHelper("is_multipage",
+        [multiPage](dom::Array const&)
+        {
+            return multiPage;
+        });
+
+    hbs.registerHelper("to_string",
+        [](dom::Array const& args)
+        {
+            // JSON.stringify of a function is
+            // undefined, which renders as nothing
+            auto const v = arg(args, 0);
+            std::string s;
+            if(! v.isFunction())
+            {
+                std::vector<void const*> path;
+                stringifyJS(s, v, path);
+            }
+            return s;
+        });
+
+    hbs.registerHelper("eq",
+        [](dom::Array const& args)
+        {
+            return isStrictEqual(arg(args, 0), arg(args, 1));
+        });
+
+    hbs.registerHelper("neq",
+        [](dom::Array const& args)
+        {
+            return ! isStrictEqual(arg(args, 0), arg(args, 1));
+        });
+
+    hbs.registerHelper("not",
+        [](dom::Array const& args)
+        {
+            return ! isTruthyJS(arg(args, 0));
+        });
+
+    hbs.registerHelper("or",
+        [](dom::Array const& args)
+        {
+            auto a = arg(args, 0);
+            if(isTruthyJS(a))
+                return a;
+            return arg(args, 1);
+        });
+
+    hbs.registerHelper("and",
+        [](dom::Array const& args)
+        {
+            auto a = arg(args, 0);
+            if(! isTruthyJS(a))
+                return a;
+            return arg(args, 1);
+        });
+
+    // The log helper reports its message,
+    // as Handlebars.log does after setlog
+    hbs.registerLogger(
+        [](dom::Value level, dom::Array const& args)
+        {
+            std::string s;
+            for(std::size_t i = 0; i < args.size(); ++i)
+            {
+                if(i != 0)
+                    s.push_back(' ');
+                auto const v = args.get(i);
+                if(v.isString())
+                    s.append(v.getString().get());
+                else
+                    s.append(toString(v));
+            }
+            report::print(report::getLevel(level.isInteger() ?
+                static_cast<unsigned>(level.getInteger()) : 1), s);
+        });
+}
+
+} // mrdox
+} // clang
@@ -0,0 +1,40 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#ifndef MRDOX_LIB_SUPPORT_GENERATORHELPERS_HPP
+#define MRDOX_LIB_SUPPORT_GENERATORHELPERS_HPP
+
+#include <mrdox/Platform.hpp>
+#include <mrdox/Config.hpp>
+#include <mrdox/Support/Handlebars.hpp>
+
+namespace clang {
+namespace mrdox {
+
+/** Register the helpers used by the generator templates.
+
+    These are the native equivalents of the helpers
+    which the generators register with handlebars.js,
+    and they follow the JavaScript semantics so that
+    both engines render the same output. In particular
+    `eq` and `neq` use strict equality, which compares
+    objects and arrays by identity, and `and` and `or`
+    return one of their operands. Messages from the
+    `log` helper are sent to the report.
+*/
+void
+registerGeneratorHelpers(
+    Handlebars& hbs,
+    Config const& config);
+
+} // mrdox
+} // clang
+
+#endif
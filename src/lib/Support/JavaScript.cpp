@@ -14,6 +14,7 @@
 #include <mrdox/Support/JavaScript.hpp>
 #include <llvm/Support/MemoryBuffer.h>
 #include <duktape.h>
+#include <cstring>
 #include <utility>
 
 #include <llvm/Support/raw_ostream.h>
@@ -210,6 +211,148 @@ dukM_popError(Scope& scope)
     return err;
 }
 
+// push the function stored in the heap stash
+// under a hidden name, creating it on first use
+static
+void
+dukM_push_stash_function(
+    Access& A,
+    char const* name,
+    duk_c_function fn,
+    duk_idx_t nargs)
+{
+    duk_push_heap_stash(A);
+    if(! duk_get_prop_string(A, -1, name))
+    {
+        duk_pop(A); // undefined
+        duk_push_c_function(A, fn, nargs);
+        duk_dup_top(A);
+        duk_put_prop_string(A, -3, name);
+    }
+    duk_remove(A, -2); // stash
+}
+
+//------------------------------------------------
+//
+// Wrapper cache
+//
+//------------------------------------------------
+
+/*  The JavaScript object for each dom::Object and
+    dom::Array is cached by the address of its
+    implementation, so a template which reaches the
+    same object many times creates one wrapper.
+    Duktape has no weak references, so the cache is
+    emptied when the outermost Scope is destroyed.
+    Each wrapper holds a reference to its
+    implementation, so an address in the cache
+    cannot be reused while its entry exists.
+*/
+
+static constexpr char const* cacheName =
+    DUK_HIDDEN_SYMBOL("cache");
+
+// push the wrapper for impl and return true,
+// or push nothing and return false
+static
+bool
+dukM_push_cached(
+    Access& A, void const* impl)
+{
+    duk_push_heap_stash(A);
+    if(! duk_get_prop_string(A, -1, cacheName))
+    {
+        duk_pop_2(A); // undefined, stash
+        return false;
+    }
+    duk_push_lstring(A,
+        reinterpret_cast<char const*>(&impl), sizeof(impl));
+    if(! duk_get_prop(A, -2))
+    {
+        duk_pop_3(A); // undefined, cache, stash
+        return false;
+    }
+    duk_remove(A, -2); // cache
+    duk_remove(A, -2); // stash
+    return true;
+}
+
+// add the wrapper on top of the stack to the cache
+static
+void
+dukM_put_cached(
+    Access& A, void const* impl)
+{
+    duk_push_heap_stash(A);
+    if(! duk_get_prop_string(A, -1, cacheName))
+    {
+        duk_pop(A); // undefined
+        duk_push_bare_object(A);
+        duk_dup_top(A);
+        duk_put_prop_string(A, -3, cacheName);
+    }
+    duk_push_lstring(A,
+        reinterpret_cast<char const*>(&impl), sizeof(impl));
+    duk_dup(A, -4); // wrapper
+    duk_put_prop(A, -3);
+    duk_pop_2(A); // cache, stash
+}
+
+// remove every wrapper from the cache
+static
+void
+dukM_clear_cache(
+    Access& A)
+{
+    duk_push_heap_stash(A);
+    duk_del_prop_string(A, -1, cacheName);
+    duk_pop(A); // stash
+}
+
+//------------------------------------------------
+//
+// Eager fields
+//
+//------------------------------------------------
+
+/*  Reading a property through a getter calls into
+    C++ and searches the dom::Object. The scalar
+    fields of an object are known when it is pushed,
+    so up to a budget they are copied as plain
+    properties instead. Arrays and objects are
+    always read through getters, so their wrappers
+    are only created when a script uses them.
+*/
+
+static constexpr char const* eagerFieldsName =
+    DUK_HIDDEN_SYMBOL("eagerFields");
+
+// return the number of scalar fields
+// copied into each object
+static
+duk_uint_t
+dukM_get_eager_fields(
+    Access& A)
+{
+    duk_push_heap_stash(A);
+    duk_get_prop_string(A, -1, eagerFieldsName);
+    auto n = duk_get_uint(A, -1);
+    duk_pop_2(A); // n, stash
+    return n;
+}
+
+void
+Context::
+setEagerFields(
+    std::size_t n)
+{
+    Access A(*this);
+    duk_push_heap_stash(A);
+    duk_push_uint(A, static_cast<duk_uint_t>(n));
+    duk_put_prop_string(A, -2, eagerFieldsName);
+    duk_pop(A); // stash
+}
+
 //------------------------------------------------
 
 void
@@ -234,6 +377,11 @@ Scope::
 {
     MRDOX_ASSERT(refs_ == 0);
     reset();
+    if(top_ == 0)
+    {
+        Access A(ctx_);
+        dukM_clear_cache(A);
+    }
 }
 
 Error
@@ -251,6 +399,40 @@ script(
     return Error::success();
 }
 
+Expected<std::string>
+Scope::
+compile(
+    std::string_view jsCode)
+{
+    Access A(*this);
+    auto failed = duk_pcompile_lstring(
+        A, 0, jsCode.data(), jsCode.size());
+    if(failed)
+        return dukM_popError(*this);
+    duk_dump_function(A);
+    duk_size_t size;
+    auto const data = static_cast<char const*>(
+        duk_get_buffer(A, -1, &size));
+    std::string bytecode(data, size);
+    duk_pop(A); // buffer
+    return bytecode;
+}
+
+Error
+Scope::
+scriptFromBytecode(
+    std::string_view bytecode)
+{
+    Access A(*this);
+    auto const data = duk_push_fixed_buffer(A, bytecode.size());
+    std::memcpy(data, bytecode.data(), bytecode.size());
+    duk_load_function(A);
+    if(duk_pcall(A, 0) != DUK_EXEC_SUCCESS)
+        return dukM_popError(*this);
+    duk_pop(A); // result
+    return Error::success();
+}
+
 Value
 Scope::
 getGlobalObject()
@@ -358,6 +540,48 @@ push(
 {
 }
 
+// Stubs for the traps which are not supported
+static
+void
+dukM_put_stub_traps(
+    Access& A, bool withOwnKeys)
+{
+    static constexpr char const* names[] = {
+        "ownKeys", "enumerate", "deleteProperty", "apply",
+        "defineProperty", "getPrototypeOf", "setPrototypeOf",
+        "isExtensible", "preventExtensions", "construct",
+        "getOwnPropertyDescriptor" };
+    for(char const* name : names)
+    {
+        if(! withOwnKeys && std::string_view(name) == "ownKeys")
+            continue;
+        duk_push_c_function(A, [](duk_context*) -> duk_ret_t {
+            return 0;
+        }, 0);
+        duk_put_prop_string(A, -2, name);
+    }
+}
+
+// push the object stored in the heap stash under
+// a hidden name, creating it with make on first use
+static
+void
+dukM_push_stash_object(
+    Access& A,
+    char const* name,
+    void(*make)(Access& A))
+{
+    duk_push_heap_stash(A);
+    if(! duk_get_prop_string(A, -1, name))
+    {
+        duk_pop(A); // undefined
+        make(A);
+        duk_dup_top(A);
+        duk_put_prop_string(A, -3, name);
+    }
+    duk_remove(A, -2); // stash
+}
+
 void
 ArrayProxy::
 push(
@@ -369,130 +593,79 @@ push(
     dukM_put_prop_string(A, -2, DUK_HIDDEN_SYMBOL("dom"));
 
     // Effects:     ~ArrayPtr
-    // Signature    ()
-    duk_push_c_function(A,
+    // Signature    (obj)
+    dukM_push_stash_function(A, DUK_HIDDEN_SYMBOL("arrayFinalizer"),
     [](duk_context* ctx) -> duk_ret_t
     {
         Access A(ctx);
-        duk_push_this(ctx);
-        std::destroy_at(get(A, -1));
+        if(auto arr = get(A, 0))
+            std::destroy_at(arr);
         return 0;
-    }, 0);
+    }, 1);
     duk_set_finalizer(A, -2);
     std::construct_at(&arr_, arr);
 
-    // Proxy
-
-    duk_push_object(A);
-
-    // store a pointer so we can
-    // get to it from the proxy.
-    duk_push_pointer(A, &arr_);
-    dukM_put_prop_string(A, -2, DUK_HIDDEN_SYMBOL("dom"));
-
-    // Trap:        [[HasProperty]]
-    // Effects:     return a[i] != undefined
-    // Signature:   (a, i)
-    duk_push_c_function(A,
-    [](duk_context* ctx) -> duk_ret_t
+    // Proxy. The traps find the dom::Array
+    // in the target, so one handler is
+    // shared by every array proxy.
+    dukM_push_stash_object(A, DUK_HIDDEN_SYMBOL("arrayHandler"),
+    [](Access& A)
     {
-        Access A(ctx);
-        duk_push_this(A);
-        auto& arr = *get(A, -1);
-        auto i = duk_to_number(A, 1);
-        duk_push_boolean(A, i < arr.size());
-        return 1;
-    }, 2);
-    dukM_put_prop_string(A, -2, "has");
+        duk_push_object(A);
 
-    // Trap:        [[Get]]
-    // Effects:     return a[i]
-    // Signature:   (a, i)
-    duk_push_c_function(A,
-    [](duk_context* ctx) -> duk_ret_t
-    {
-        Access A(ctx);
-        duk_push_this(A);
-        auto& arr = *get(A, -1);
-        switch(duk_get_type(A, 1))
-        {
-        case DUK_TYPE_NUMBER:
+        // Trap:        [[HasProperty]]
+        // Effects:     return a[i] != undefined
+        // Signature:   (a, i)
+        duk_push_c_function(A,
+        [](duk_context* ctx) -> duk_ret_t
         {
-            auto i = duk_get_int(A, 1);
-            duk_pop_n(A, duk_get_top(A));
-            if(i < static_cast<duk_int_t>(arr.size()))
-                domValue_push(A, arr.at(i));
-            else
-                duk_push_undefined(A);
-            break;
-        }
-        case DUK_TYPE_STRING:
+            Access A(ctx);
+            auto& arr = *get(A, 0);
+            auto i = duk_to_number(A, 1);
+            duk_push_boolean(A, i < arr.size());
+            return 1;
+        }, 2);
+        dukM_put_prop_string(A, -2, "has");
+
+        // Trap:        [[Get]]
+        // Effects:     return a[i]
+        // Signature:   (a, i)
+        duk_push_c_function(A,
+        [](duk_context* ctx) -> duk_ret_t
         {
-            auto prop = dukM_get_string(A, 1);
-            if(prop == "length")
+            Access A(ctx);
+            // the target owns the array
+            // and stays on the stack
+            auto& arr = *get(A, 0);
+            switch(duk_get_type(A, 1))
+            {
+            case DUK_TYPE_NUMBER:
             {
-                duk_pop_n(A, duk_get_top(A));
-                duk_push_number(A, arr.size());
+                auto i = duk_get_int(A, 1);
+                if(i < static_cast<duk_int_t>(arr.size()))
+                    domValue_push(A, arr.at(i));
+                else
+                    duk_push_undefined(A);
+                break;
             }
-            else
+            case DUK_TYPE_STRING:
             {
-                duk_pop_n(A, duk_get_top(A));
-                duk_push_undefined(A);
+                auto prop = dukM_get_string(A, 1);
+                if(prop == "length")
+                    duk_push_number(A, arr.size());
+                else
+                    duk_push_undefined(A);
+                break;
             }
-            break;
-        }
-        default:
-            MRDOX_UNREACHABLE();
-        }
-        return 1;
-    }, 2);
-    dukM_put_prop_string(A, -2, "get");
-
-#if 1
-    duk_push_c_function(A, [](duk_context* ctx) -> duk_ret_t {
-        return 0;
-    }, 0); dukM_put_prop_string(A, -2, "ownKeys");
-
-    duk_push_c_function(A, [](duk_context* ctx) -> duk_ret_t {
-        return 0;
-    }, 0); dukM_put_prop_string(A, -2, "enumerate");
-
-    duk_push_c_function(A, [](duk_context* ctx) -> duk_ret_t {
-        return 0;
-    }, 0); dukM_put_prop_string(A, -2, "deleteProperty");
-
-    duk_push_c_function(A, [](duk_context* ctx) -> duk_ret_t {
-        return 0;
-    }, 0); dukM_put_prop_string(A, -2, "apply");
-
-    duk_push_c_function(A, [](duk_context* ctx) -> duk_ret_t {
-        return 0;
-    }, 0); dukM_put_prop_string(A, -2, "defineProperty");
-
-    duk_push_c_function(A, [](duk_context* ctx) -> duk_ret_t {
-        return 0;
-    }, 0); dukM_put_prop_string(A, -2, "getPrototypeOf");
-
-    duk_push_c_function(A, [](duk_context* ctx) -> duk_ret_t {
-        return 0;
-    }, 0); dukM_put_prop_string(A, -2, "setPrototypeOf");
-
-    duk_push_c_function(A, [](duk_context* ctx) -> duk_ret_t {
-        return 0;
-    }, 0); dukM_put_prop_string(A, -2, "isExtensible");
-
-    duk_push_c_function(A, [](duk_context* ctx) -> duk_ret_t {
-        return 0;
-    }, 0); dukM_put_prop_string(A, -2, "preventExtensions");
-
-    duk_push_c_function(A, [](duk_context* ctx) -> duk_ret_t {
-        return 0;
-    }, 0); dukM_put_prop_string(A, -2, "construct");
+            default:
+                MRDOX_UNREACHABLE();
+            }
+            return 1;
+        }, 2);
+        dukM_put_prop_string(A, -2, "get");
 
-    duk_push_c_function(A, [](duk_context* ctx) -> duk_ret_t {
-        return 0;
-    }, 0); dukM_put_prop_string(A, -2, "getOwnPropertyDescriptor");
-#endif
+        dukM_put_stub_traps(A, true);
+    });
 
     duk_push_proxy(A, 0);
 }
@@ -522,6 +695,18 @@ get(Access& A, duk_idx_t idx)
     return static_cast<dom::Object*>(data);
 }
 
+// Effects:     ~ObjectPtr
+// Signature    (obj)
+static
+duk_ret_t
+objectFinalizer(duk_context* ctx)
+{
+    Access A(ctx);
+    if(auto obj = ObjectBase::get(A, 0))
+        std::destroy_at(obj);
+    return 0;
+}
+
 void
 ObjectGetSet::
 push(
@@ -533,27 +718,33 @@ push(
         duk_push_fixed_buffer(A, sizeof(dom::Object)));
     dukM_put_prop_string(A, idx, DUK_HIDDEN_SYMBOL("dom"));
 
-    // Effects:     ~ObjectPtr
-    // Signature    ()
-    duk_push_c_function(A,
-    [](duk_context* ctx) -> duk_ret_t
-    {
-        Access A(ctx);
-        duk_push_this(ctx);
-        std::destroy_at(get(A, -1));
-        return 0;
-    }, 0);
+    dukM_push_stash_function(A,
+        DUK_HIDDEN_SYMBOL("objectFinalizer"), objectFinalizer, 1);
     duk_set_finalizer(A, idx);
     std::construct_at(&obj_, obj);
 
+    // Scalars are copied as plain properties,
+    // up to the budget set for the context.
+    auto eager = dukM_get_eager_fields(A);
     for(auto const& kv : obj)
     {
         dukM_push_string(A, kv.key);
+        if(eager != 0 &&
+            ! kv.value.isArray() &&
+            ! kv.value.isObject())
+        {
+            --eager;
+            domValue_push(A, kv.value);
+            duk_put_prop(A, idx);
+            continue;
+        }
 
         // Method:      Getter
         // Effects:     return obj[key]
         // Signature:   (key)
-        duk_push_c_function(A,
+        // The getter receives the key, so one
+        // function serves every property.
+        dukM_push_stash_function(A, DUK_HIDDEN_SYMBOL("objectGetter"),
         [](duk_context* ctx) -> duk_ret_t
         {
             Access A(ctx);
@@ -582,125 +773,71 @@ push(
         duk_push_fixed_buffer(A, sizeof(dom::Object)));
     dukM_put_prop_string(A, -2, DUK_HIDDEN_SYMBOL("dom"));
 
-    // Effects:     ~ObjectPtr
-    // Signature    ()
-    duk_push_c_function(A,
-    [](duk_context* ctx) -> duk_ret_t
-    {
-        Access A(ctx);
-        duk_push_this(ctx);
-        std::destroy_at(get(A, -1));
-        return 0;
-    }, 0);
+    dukM_push_stash_function(A,
+        DUK_HIDDEN_SYMBOL("objectFinalizer"), objectFinalizer, 1);
     duk_set_finalizer(A, -2);
     std::construct_at(&obj_, obj);
 
-    // Proxy
-
-    duk_push_object(A);
-
-    // store a pointer so we can
-    // get to it from the proxy.
-    duk_push_pointer(A, &obj_);
-    dukM_put_prop_string(A, -2, DUK_HIDDEN_SYMBOL("dom"));
-
-    // Trap:        [[Get]]
-    // Effects:     return target[prop]
-    // Signature:   (target, prop, receiver)
-    duk_push_c_function(A,
-    [](duk_context* ctx) -> duk_ret_t
+    // Proxy. The traps find the dom::Object
+    // in the target, so one handler is
+    // shared by every object proxy.
+    dukM_push_stash_object(A, DUK_HIDDEN_SYMBOL("objectHandler"),
+    [](Access& A)
     {
-        Access A(ctx);
-        duk_push_this(A); // the proxy
-        auto& obj = *get(A, -1);
-        auto key = dukM_get_string(A, 1);
-        auto const& v = obj.find(key);
-        duk_pop_n(A, duk_get_top(A));
-        domValue_push(A, v);
-        return 1;
-    }, 3);
-    dukM_put_prop_string(A, -2, "get");
-
-    // Trap:        [[HasProperty]]
-    // Effects:     return t[k] != null
-    // Signature:   (t, k, r)
-    duk_push_c_function(A,
-    [](duk_context* ctx) -> duk_ret_t
-    {
-        Access A(ctx);
-        duk_push_this(A);
-        auto& obj = *get(A, -1);
-        auto key = dukM_get_string(A, 1);
-        auto const& v = obj.find(key);
-        duk_pop_n(A, duk_get_top(A));
-        // VFALCO should add dom::Object::exists(k) for this
-        duk_push_boolean(A, ! v.isNull());
-        return 1;
-    }, 3);
-    dukM_put_prop_string(A, -2, "has");
+        duk_push_object(A);
 
-#if 1
-    // Trap:        [[OwnPropertyKeys]]
-    // Effects:     return range(Object())
-    // Signature:   ()
-    duk_push_c_function(A,
-    [](duk_context* ctx) -> duk_ret_t
-    {
-        Access A(ctx);
-        duk_push_this(A);
-        auto& obj = *get(A, -1);
-        duk_pop(A);
-        duk_push_array(A);
-        for(auto const& kv : obj)
+        // Trap:        [[Get]]
+        // Effects:     return target[prop]
+        // Signature:   (target, prop, receiver)
+        duk_push_c_function(A,
+        [](duk_context* ctx) -> duk_ret_t
         {
-            dukM_push_string(A, kv.key);
-            domValue_push(A, kv.value);
-            duk_put_prop(A, -3);
-        }
-        return 1;
-    }, 0);
-    dukM_put_prop_string(A, -2, "ownKeys");
-
-    duk_push_c_function(A, [](duk_context* ctx) -> duk_ret_t {
-        return 0;
-    }, 0); dukM_put_prop_string(A, -2, "enumerate");
-
-    duk_push_c_function(A, [](duk_context* ctx) -> duk_ret_t {
-        return 0;
-    }, 0); dukM_put_prop_string(A, -2, "deleteProperty");
-
-    duk_push_c_function(A, [](duk_context* ctx) -> duk_ret_t {
-        return 0;
-    }, 0); dukM_put_prop_string(A, -2, "apply");
-
-    duk_push_c_function(A, [](duk_context* ctx) -> duk_ret_t {
-        return 0;
-    }, 0); dukM_put_prop_string(A, -2, "defineProperty");
-
-    duk_push_c_function(A, [](duk_context* ctx) -> duk_ret_t {
-        return 0;
-    }, 0); dukM_put_prop_string(A, -2, "getPrototypeOf");
-
-    duk_push_c_function(A, [](duk_context* ctx) -> duk_ret_t {
-        return 0;
-    }, 0); dukM_put_prop_string(A, -2, "setPrototypeOf");
-
-    duk_push_c_function(A, [](duk_context* ctx) -> duk_ret_t {
-        return 0;
-    }, 0); dukM_put_prop_string(A, -2, "isExtensible");
+            Access A(ctx);
+            // the target owns the object
+            // and stays on the stack
+            auto& obj = *get(A, 0);
+            auto key = dukM_get_string(A, 1);
+            domValue_push(A, obj.find(key));
+            return 1;
+        }, 3);
+        dukM_put_prop_string(A, -2, "get");
 
-    duk_push_c_function(A, [](duk_context* ctx) -> duk_ret_t {
-        return 0;
-    }, 0); dukM_put_prop_string(A, -2, "preventExtensions");
+        // Trap:        [[HasProperty]]
+        // Effects:     return t[k] != null
+        // Signature:   (t, k, r)
+        duk_push_c_function(A,
+        [](duk_context* ctx) -> duk_ret_t
+        {
+            Access A(ctx);
+            auto& obj = *get(A, 0);
+            auto key = dukM_get_string(A, 1);
+            // VFALCO should add dom::Object::exists(k) for this
+            duk_push_boolean(A, ! obj.find(key).isNull());
+            return 1;
+        }, 3);
+        dukM_put_prop_string(A, -2, "has");
 
-    duk_push_c_function(A, [](duk_context* ctx) -> duk_ret_t {
-        return 0;
-    }, 0); dukM_put_prop_string(A, -2, "construct");
+        // Trap:        [[OwnPropertyKeys]]
+        // Effects:     return range(Object())
+        // Signature:   (target)
+        duk_push_c_function(A,
+        [](duk_context* ctx) -> duk_ret_t
+        {
+            Access A(ctx);
+            auto& obj = *get(A, 0);
+            duk_push_array(A);
+            for(auto const& kv : obj)
+            {
+                dukM_push_string(A, kv.key);
+                domValue_push(A, kv.value);
+                duk_put_prop(A, -3);
+            }
+            return 1;
+        }, 1);
+        dukM_put_prop_string(A, -2, "ownKeys");
 
-    duk_push_c_function(A, [](duk_context* ctx) -> duk_ret_t {
-        return 0;
-    }, 0); dukM_put_prop_string(A, -2, "getOwnPropertyDescriptor");
-#endif
+        dukM_put_stub_traps(A, false);
+    });
 
     duk_push_proxy(A, 0);
 }
@@ -764,11 +901,23 @@ domValue_push(
         dukM_push_string(A, value.getString());
         return;
     case dom::Kind::Array:
-        ArrayRep::push(A, value.getArray());
+    {
+        auto const& arr = value.getArray();
+        if(dukM_push_cached(A, arr.impl().get()))
+            return;
+        ArrayRep::push(A, arr);
+        dukM_put_cached(A, arr.impl().get());
         return;
+    }
     case dom::Kind::Object:
-        ObjectRep::push(A, value.getObject());
+    {
+        auto const& obj = value.getObject();
+        if(dukM_push_cached(A, obj.impl().get()))
+            return;
+        ObjectRep::push(A, obj);
+        dukM_put_cached(A, obj.impl().get());
         return;
+    }
     default:
         MRDOX_UNREACHABLE();
     }
@@ -0,0 +1,272 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#include "lib/Support/Memory.hpp"
+#include <llvm/Support/JSON.h>
+#include <llvm/Support/Process.h>
+#include <llvm/Support/raw_ostream.h>
+#include <fmt/format.h>
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+
+#if defined(_WIN32)
+# ifndef WIN32_LEAN_AND_MEAN
+#  define WIN32_LEAN_AND_MEAN
+# endif
+# include <windows.h>
+# include <psapi.h>
+#elif defined(__unix__) || defined(__APPLE__)
+# include <sys/resource.h>
+#endif
+
+namespace clang {
+namespace mrdox {
+
+namespace {
+
+#if defined(__linux__)
+// Return the value of a "Vm" field of
+// /proc/self/status in bytes, or zero.
+std::size_t
+parseStatusField(
+    std::string_view line,
+    std::string_view key)
+{
+    if(! line.starts_with(key))
+        return 0;
+    line.remove_prefix(key.size());
+    std::size_t kb = 0;
+    for(char c : line)
+    {
+        if(c >= '0' && c <= '9')
+            kb = kb * 10 + (c - '0');
+        else if(kb != 0)
+            break;
+    }
+    return kb * 1024;
+}
+#endif
+
+std::string
+formatBytes(std::size_t n)
+{
+    if(n == 0)
+        return "-";
+    return fmt::format("{:.1f} MiB",
+        static_cast<double>(n) / (1024 * 1024));
+}
+
+} // (anon)
+
+MemoryUsage
+getMemoryUsage() noexcept
+{
+    MemoryUsage usage;
+    usage.live = llvm::sys::Process::GetMallocUsage();
+
+#if defined(__linux__)
+    std::ifstream is("/proc/self/status");
+    std::string line;
+    while(std::getline(is, line))
+    {
+        if(auto rss = parseStatusField(line, "VmRSS:"))
+            usage.resident = rss;
+        else if(auto hwm = parseStatusField(line, "VmHWM:"))
+            usage.peakResident = hwm;
+    }
+#elif defined(_WIN32)
+    PROCESS_MEMORY_COUNTERS pmc;
+    if(GetProcessMemoryInfo(GetCurrentProcess(), &pmc, sizeof(pmc)))
+    {
+        usage.resident = pmc.WorkingSetSize;
+        usage.peakResident = pmc.PeakWorkingSetSize;
+    }
+#elif defined(__unix__) || defined(__APPLE__)
+    struct rusage ru;
+    if(getrusage(RUSAGE_SELF, &ru) == 0)
+    {
+    #if defined(__APPLE__)
+        usage.peakResident = ru.ru_maxrss;
+    #else
+        usage.peakResident = ru.ru_maxrss * 1024;
+    #endif
+    }
+#endif
+    return usage;
+}
+
+//------------------------------------------------
+//
+// MemoryReport
+//
+//------------------------------------------------
+
+void
+MemoryReport::
+record(
+    std::string_view phase)
+{
+    record(phase, 0, 0);
+}
+
+void
+MemoryReport::
+record(
+    std::string_view phase,
+    std::size_t count,
+    std::size_t bytes)
+{
+    if(! enabled())
+        return;
+    auto usage = getMemoryUsage();
+    std::lock_guard<std::mutex> lock(mutex_);
+    entries_.push_back({
+        std::string(phase), usage, count, bytes });
+}
+
+std::string
+MemoryReport::
+toTable() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string s;
+    fmt::format_to(std::back_inserter(s),
+        "{:<28}{:>14}{:>14}{:>14}{:>12}{:>14}\n",
+        "phase", "rss", "peak rss", "live", "count", "size");
+    for(auto const& e : entries_)
+        fmt::format_to(std::back_inserter(s),
+            "{:<28}{:>14}{:>14}{:>14}{:>12}{:>14}\n",
+            e.phase,
+            formatBytes(e.usage.resident),
+            formatBytes(e.usage.peakResident),
+            formatBytes(e.usage.live),
+            e.count,
+            formatBytes(e.bytes));
+    return s;
+}
+
+std::string
+MemoryReport::
+toJSON() const
+{
+    std::lock_guard<std::mutex> lock(mutex_);
+    std::string s;
+    llvm::raw_string_ostream os(s);
+    llvm::json::OStream J(os, 2);
+    J.object([&]
+    {
+        J.attributeArray("phases", [&]
+        {
+            for(auto const& e : entries_)
+                J.object([&]
+                {
+                    J.attribute("phase", e.phase);
+                    J.attribute("resident", std::int64_t(e.usage.resident));
+                    J.attribute("peakResident", std::int64_t(e.usage.peakResident));
+                    J.attribute("live", std::int64_t(e.usage.live));
+                    J.attribute("count", std::int64_t(e.count));
+                    J.attribute("bytes", std::int64_t(e.bytes));
+                });
+        });
+    });
+    os << '\n';
+    os.flush();
+    return s;
+}
+
+MemoryReport&
+memoryReport() noexcept
+{
+    static MemoryReport report;
+    return report;
+}
+
+//------------------------------------------------
+//
+// MemoryGate
+//
+//------------------------------------------------
+
+namespace {
+
+using sampleClock = std::chrono::steady_clock;
+
+constexpr std::chrono::milliseconds sampleInterval(20);
+
+std::int64_t
+sampleTime() noexcept
+{
+    return std::chrono::duration_cast<
+        std::chrono::milliseconds>(
+            sampleClock::now().time_since_epoch()).count();
+}
+
+} // (anon)
+
+MemoryGate::
+MemoryGate(
+    std::size_t limit) noexcept
+    : limit_(limit)
+    , sampled_(sampleTime() - sampleInterval.count())
+{
+}
+
+void
+MemoryGate::
+sample() noexcept
+{
+    auto const now = sampleTime();
+    auto last = sampled_.load(std::memory_order_relaxed);
+    if(now - last < sampleInterval.count())
+        return;
+    // Only one thread takes each sample
+    if(! sampled_.compare_exchange_strong(
+            last, now, std::memory_order_relaxed))
+        return;
+    // Prefer the heap usage, since the
+    // resident size rarely goes back down.
+    auto usage = getMemoryUsage();
+    used_.store(usage.live != 0 ?
+        usage.live : usage.resident,
+        std::memory_order_relaxed);
+}
+
+void
+MemoryGate::
+enter()
+{
+    sample();
+    std::unique_lock<std::mutex> lock(mutex_);
+    cv_.wait(lock,
+        [&]
+        {
+            return running_ == 0 ||
+                used_.load(std::memory_order_relaxed) < limit_;
+        });
+    ++running_;
+}
+
+void
+MemoryGate::
+leave() noexcept
+{
+    // Work which finished may have freed memory,
+    // so let the waiters see a fresh sample.
+    sample();
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        --running_;
+    }
+    cv_.notify_all();
+}
+
+} // mrdox
+} // clang
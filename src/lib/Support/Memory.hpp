@@ -0,0 +1,203 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#ifndef MRDOX_LIB_SUPPORT_MEMORY_HPP
+#define MRDOX_LIB_SUPPORT_MEMORY_HPP
+
+#include <mrdox/Platform.hpp>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <vector>
+
+namespace clang {
+namespace mrdox {
+
+/** A snapshot of the memory used by the process.
+
+    Fields which cannot be determined on the
+    current platform are set to zero.
+*/
+struct MemoryUsage
+{
+    /** The resident set size, in bytes.
+    */
+    std::size_t resident = 0;
+
+    /** The peak resident set size, in bytes.
+    */
+    std::size_t peakResident = 0;
+
+    /** The number of bytes allocated from the heap.
+    */
+    std::size_t live = 0;
+};
+
+/** Return the current memory usage of the process.
+*/
+MemoryUsage
+getMemoryUsage() noexcept;
+
+//------------------------------------------------
+
+/** Per-phase accounting of memory usage.
+
+    Each entry records a snapshot of the memory
+    used by the process when a phase ends, along
+    with the number and approximate size of the
+    objects which the phase is responsible for.
+
+    Recording does nothing unless the report is
+    enabled, so call sites do not need to check.
+
+    @par Thread Safety
+    May be called concurrently.
+*/
+class MemoryReport
+{
+public:
+    struct Entry
+    {
+        std::string phase;
+        MemoryUsage usage;
+        std::size_t count = 0;
+        std::size_t bytes = 0;
+    };
+
+    /** Return true if the report is collecting entries.
+    */
+    bool
+    enabled() const noexcept
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    /** Start collecting entries.
+    */
+    void
+    enable() noexcept
+    {
+        enabled_ = true;
+    }
+
+    /** Record the memory usage at the end of a phase.
+    */
+    void
+    record(
+        std::string_view phase);
+
+    /** Record the memory usage at the end of a phase.
+
+        @param count The number of objects
+        held by the phase.
+
+        @param bytes The approximate number of
+        bytes held by the phase.
+    */
+    void
+    record(
+        std::string_view phase,
+        std::size_t count,
+        std::size_t bytes);
+
+    /** Return the report as a human readable table.
+    */
+    std::string
+    toTable() const;
+
+    /** Return the report as JSON.
+    */
+    std::string
+    toJSON() const;
+
+private:
+    std::atomic<bool> enabled_ = false;
+    mutable std::mutex mutex_;
+    std::vector<Entry> entries_;
+};
+
+/** Return the process-wide memory report.
+*/
+MemoryReport&
+memoryReport() noexcept;
+
+//------------------------------------------------
+
+/** Applies backpressure when memory usage is too high.
+
+    Work which enters the gate while the memory
+    used by the process exceeds the limit waits
+    until no other work is running. This limits
+    the concurrency to one until usage drops.
+
+    Usage is sampled outside the lock, at most
+    once per interval, by whichever thread enters
+    or leaves the gate first after the interval
+    elapses. Waiting threads only read the
+    last sample.
+*/
+class MemoryGate
+{
+    std::size_t limit_;
+    std::mutex mutex_;
+    std::condition_variable cv_;
+    unsigned running_ = 0;
+
+    std::atomic<std::size_t> used_ = 0;
+    std::atomic<std::int64_t> sampled_;
+
+    void sample() noexcept;
+
+public:
+    class Guard
+    {
+        MemoryGate* gate_;
+
+    public:
+        explicit
+        Guard(MemoryGate* gate)
+            : gate_(gate)
+        {
+            if(gate_)
+                gate_->enter();
+        }
+
+        ~Guard()
+        {
+            if(gate_)
+                gate_->leave();
+        }
+    };
+
+    /** Constructor.
+
+        @param limit The limit in bytes.
+    */
+    explicit
+    MemoryGate(
+        std::size_t limit) noexcept;
+
+    /** Block until work may run.
+    */
+    void enter();
+
+    /** Indicate that work has completed.
+    */
+    void leave() noexcept;
+};
+
+} // mrdox
+} // clang
+
+#endif
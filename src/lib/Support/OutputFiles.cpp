@@ -0,0 +1,529 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#include "lib/Support/OutputFiles.hpp"
+#include <mrdox/Support/Path.hpp>
+#include <mrdox/Support/ThreadPool.hpp>
+#include <fmt/format.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/Process.h>
+#include <llvm/Support/raw_ostream.h>
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+
+#if defined(_WIN32)
+# include <io.h>
+#else
+# include <unistd.h>
+#endif
+
+namespace clang {
+namespace mrdox {
+
+namespace {
+
+// Return true if the file exists and
+// has exactly the given contents.
+bool
+isSame(
+    llvm::StringRef filePath,
+    std::string_view text)
+{
+    namespace fs = llvm::sys::fs;
+
+    std::uint64_t size;
+    if(fs::file_size(filePath, size) || size != text.size())
+        return false;
+    auto buf = llvm::MemoryBuffer::getFile(
+        filePath, false, false);
+    if(! buf)
+        return false;
+    return (*buf)->getBuffer() == llvm::StringRef(
+        text.data(), text.size());
+}
+
+// Return true if a name from a manifest names
+// a file inside the output directory. A manifest
+// which was edited or damaged must not lead to
+// removing files elsewhere.
+bool
+isRelativeName(
+    llvm::StringRef name)
+{
+    namespace path = llvm::sys::path;
+
+    if( name.empty() ||
+        path::is_absolute(name) ||
+        path::has_root_name(name) ||
+        path::has_root_directory(name))
+        return false;
+    for(auto it = path::begin(name), end = path::end(name);
+            it != end; ++it)
+        if(*it == "..")
+            return false;
+    return true;
+}
+
+// Flush an open file to stable storage
+std::error_code
+syncFile(int fd)
+{
+#if defined(_WIN32)
+    if(::_commit(fd) != 0)
+#else
+    if(::fsync(fd) != 0)
+#endif
+        return std::error_code(errno, std::generic_category());
+    return {};
+}
+
+// Flush a file which was already closed
+Error
+syncPath(
+    std::string const& filePath)
+{
+    namespace fs = llvm::sys::fs;
+
+    int fd;
+    if(auto ec = fs::openFileForWrite(
+            filePath, fd, fs::CD_OpenExisting, fs::OF_Append))
+        return formatError("could not open \"{}\": {}", filePath, ec);
+    auto ec = syncFile(fd);
+    llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+    if(ec)
+        return formatError("could not flush \"{}\": {}", filePath, ec);
+    return Error::success();
+}
+
+// The size of a block in a tar file
+constexpr std::size_t tarBlock = 512;
+
+// Store a number in a tar header field as
+// octal digits followed by a NUL.
+void
+putOctal(
+    char* field,
+    std::size_t size,
+    std::uint64_t value)
+{
+    auto digits = fmt::format("{:0{}o}", value, size - 1);
+    std::memcpy(field, digits.data(), size - 1);
+    field[size - 1] = '\0';
+}
+
+void
+putHeader(
+    llvm::raw_ostream& os,
+    std::string_view name,
+    std::uint64_t size,
+    char type)
+{
+    char h[tarBlock] = {};
+    std::memcpy(h, name.data(), std::min<std::size_t>(name.size(), 100));
+    putOctal(h + 100, 8, 0644);
+    putOctal(h + 108, 8, 0);
+    putOctal(h + 116, 8, 0);
+    putOctal(h + 124, 12, size);
+    putOctal(h + 136, 12, 0);
+    h[156] = type;
+    std::memcpy(h + 257, "ustar", 6);
+    std::memcpy(h + 263, "00", 2);
+
+    // The checksum is computed with
+    // its own field set to spaces.
+    std::memset(h + 148, ' ', 8);
+    unsigned sum = 0;
+    for(unsigned char c : h)
+        sum += c;
+    putOctal(h + 148, 7, sum);
+    os.write(h, tarBlock);
+}
+
+// Fill the rest of the last block of an entry
+void
+putPadding(
+    llvm::raw_ostream& os,
+    std::uint64_t size)
+{
+    static constexpr char zeros[tarBlock] = {};
+    if(auto n = size % tarBlock)
+        os.write(zeros, tarBlock - n);
+}
+
+// Return a PAX extended header record. The
+// length at the front counts its own digits.
+std::string
+paxRecord(
+    std::string_view key,
+    std::string_view value)
+{
+    std::size_t const n = key.size() + value.size() + 3;
+    std::size_t len = n + std::to_string(n).size();
+    if(std::to_string(len).size() > std::to_string(n).size())
+        ++len;
+    return fmt::format("{} {}={}\n", len, key, value);
+}
+
+} // (anon)
+
+Expected<FsyncPolicy>
+parseFsyncPolicy(
+    std::string_view name)
+{
+    if(name == "none")
+        return FsyncPolicy::none;
+    if(name == "files")
+        return FsyncPolicy::files;
+    if(name == "finish")
+        return FsyncPolicy::finish;
+    return formatError(
+        "the fsync policy \"{}\" is not none, files, or finish", name);
+}
+
+//------------------------------------------------
+
+OutputFiles::
+OutputFiles(
+    std::string_view outputPath,
+    std::string_view ext,
+    Config const& config)
+    : outputPath_(outputPath)
+    , ext_(ext)
+    , manifestPath_(files::appendPath(
+        outputPath, fmt::format(".mrdox-{}.manifest", ext)))
+    , fsync_(parseFsyncPolicy(config->fsync).value())
+{
+    if(config->archive)
+    {
+        archivePath_ = files::appendPath(
+            outputPath, fmt::format("reference.{}.tar", ext));
+        // A failure is returned by the first call
+        // to write, so nothing is queued after it.
+        namespace fs = llvm::sys::fs;
+        std::error_code ec = fs::create_directories(outputPath_);
+        if(ec)
+            errors_.emplace_back(formatError(
+                "could not create \"{}\": {}", outputPath_, ec));
+        else if((ec = fs::openFileForWrite(
+                archivePath_, archiveFd_, fs::CD_CreateAlways)))
+            errors_.emplace_back(formatError(
+                "could not open \"{}\": {}", archivePath_, ec));
+        else
+            archive_ = std::make_unique<llvm::raw_fd_ostream>(
+                archiveFd_, true);
+    }
+
+    // The render threads outnumber the writers,
+    // since most of the time goes to rendering.
+    // An archive is appended to by one thread.
+    unsigned const threadCount =
+        config.threadPool().getThreadCount();
+    unsigned const n = ! archivePath_.empty() ? 1 :
+        std::clamp(threadCount / 4, 1u, 4u);
+    capacity_ = std::max<std::size_t>(64, 16 * threadCount);
+    threads_.reserve(n);
+    for(unsigned i = 0; i < n; ++i)
+        threads_.emplace_back(&OutputFiles::run, this);
+}
+
+OutputFiles::
+~OutputFiles()
+{
+    stop();
+}
+
+Error
+OutputFiles::
+write(
+    std::string fileName,
+    std::string text)
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    if(! errors_.empty())
+        return errors_.front();
+    queueSpace_.wait(lock,
+        [&]
+        {
+            return queue_.size() < capacity_;
+        });
+    names_.push_back(fileName);
+    queue_.push_back({ std::move(fileName), std::move(text) });
+    queueReady_.notify_one();
+    return Error::success();
+}
+
+Error
+OutputFiles::
+finish()
+{
+    stop();
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    if(! errors_.empty())
+        return Error(errors_);
+    if(! archivePath_.empty())
+        return finishArchive();
+
+    if(fsync_ == FsyncPolicy::finish)
+    {
+        for(auto const& filePath : synced_)
+            if(auto err = syncPath(filePath))
+                return err;
+    }
+
+    std::sort(names_.begin(), names_.end());
+    std::size_t removed = removeStale();
+
+    // An archive from a previous run
+    // would no longer match the files.
+    std::string tarPath = files::appendPath(
+        outputPath_, fmt::format("reference.{}.tar", ext_));
+    for(auto const& filePath : { tarPath, tarPath + ".index" })
+        if(! llvm::sys::fs::remove(filePath, false))
+            ++removed;
+
+    std::error_code ec;
+    llvm::raw_fd_ostream os(manifestPath_, ec, llvm::sys::fs::CD_CreateAlways);
+    if(ec)
+        return formatError("could not open \"{}\": {}", manifestPath_, ec);
+    for(auto const& name : names_)
+        os << name << '\n';
+    os.close();
+    if(os.has_error())
+        return formatError("could not write \"{}\": {}", manifestPath_, os.error());
+    if(fsync_ != FsyncPolicy::none)
+        if(auto err = syncPath(manifestPath_))
+            return err;
+
+    report::info("{} files written, {} unchanged, {} removed",
+        written_.load(), unchanged_.load(), removed);
+    return Error::success();
+}
+
+//------------------------------------------------
+
+// Let the writers drain the queue, then join them
+void
+OutputFiles::
+stop()
+{
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopped_ = true;
+    }
+    queueReady_.notify_all();
+    for(auto& t : threads_)
+        t.join();
+    threads_.clear();
+}
+
+void
+OutputFiles::
+run()
+{
+    std::unique_lock<std::mutex> lock(mutex_);
+    for(;;)
+    {
+        queueReady_.wait(lock,
+            [&]
+            {
+                return stopped_ || ! queue_.empty();
+            });
+        if(queue_.empty())
+            return;
+        File file = std::move(queue_.front());
+        queue_.pop_front();
+        queueSpace_.notify_one();
+
+        lock.unlock();
+        auto err = writeFile(file);
+        lock.lock();
+        if(err)
+            errors_.emplace_back(std::move(err));
+    }
+}
+
+Error
+OutputFiles::
+writeFile(
+    File const& file)
+{
+    namespace fs = llvm::sys::fs;
+
+    if(! archivePath_.empty())
+        return appendFile(file);
+
+    std::string filePath = files::appendPath(outputPath_, file.name);
+    if(isSame(filePath, file.text))
+    {
+        ++unchanged_;
+        return Error::success();
+    }
+    if(auto err = createDirectory(filePath))
+        return err;
+
+    int fd;
+    if(auto ec = fs::openFileForWrite(filePath, fd, fs::CD_CreateAlways))
+        return formatError("could not open \"{}\": {}", filePath, ec);
+    llvm::raw_fd_ostream os(fd, true);
+    os.write(file.text.data(), file.text.size());
+    os.flush();
+    std::error_code ec;
+    if(fsync_ == FsyncPolicy::files && ! os.has_error())
+        ec = syncFile(fd);
+    os.close();
+    if(os.has_error())
+        return formatError("could not write \"{}\": {}", filePath, os.error());
+    if(ec)
+        return formatError("could not flush \"{}\": {}", filePath, ec);
+    if(fsync_ == FsyncPolicy::finish)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        synced_.push_back(std::move(filePath));
+    }
+    ++written_;
+    return Error::success();
+}
+
+Error
+OutputFiles::
+appendFile(
+    File const& file)
+{
+    auto& os = *archive_;
+    if(file.name.size() > 100)
+    {
+        // The name does not fit in the header,
+        // so it goes in an extended header.
+        std::string record = paxRecord("path", file.name);
+        putHeader(os, "PaxHeader", record.size(), 'x');
+        os << record;
+        putPadding(os, record.size());
+    }
+    putHeader(os, file.name, file.text.size(), '0');
+    entries_.push_back({ file.name, os.tell(), file.text.size() });
+    os.write(file.text.data(), file.text.size());
+    putPadding(os, file.text.size());
+    if(os.has_error())
+        return formatError("could not write \"{}\": {}", archivePath_, os.error());
+    if(fsync_ == FsyncPolicy::files)
+    {
+        os.flush();
+        if(auto ec = syncFile(archiveFd_))
+            return formatError("could not flush \"{}\": {}", archivePath_, ec);
+    }
+    ++written_;
+    return Error::success();
+}
+
+// End the archive, then write its index
+Error
+OutputFiles::
+finishArchive()
+{
+    auto& os = *archive_;
+    static constexpr char zeros[2 * tarBlock] = {};
+    os.write(zeros, sizeof(zeros));
+    os.flush();
+    std::error_code ec;
+    if(fsync_ != FsyncPolicy::none && ! os.has_error())
+        ec = syncFile(archiveFd_);
+    os.close();
+    if(os.has_error())
+        return formatError("could not write \"{}\": {}", archivePath_, os.error());
+    if(ec)
+        return formatError("could not flush \"{}\": {}", archivePath_, ec);
+
+    std::sort(entries_.begin(), entries_.end(),
+        [](Entry const& e0, Entry const& e1)
+        {
+            return e0.name < e1.name;
+        });
+    std::string indexPath = archivePath_ + ".index";
+    llvm::raw_fd_ostream index(indexPath, ec, llvm::sys::fs::CD_CreateAlways);
+    if(ec)
+        return formatError("could not open \"{}\": {}", indexPath, ec);
+    for(auto const& e : entries_)
+        index << e.offset << ' ' << e.size << ' ' << e.name << '\n';
+    index.close();
+    if(index.has_error())
+        return formatError("could not write \"{}\": {}", indexPath, index.error());
+    if(fsync_ != FsyncPolicy::none)
+        if(auto err = syncPath(indexPath))
+            return err;
+
+    // Files written by a previous run without
+    // the archive are now in the archive.
+    names_.clear();
+    removeStale();
+    llvm::sys::fs::remove(manifestPath_);
+
+    report::info("{} files archived in \"{}\"",
+        written_.load(), archivePath_);
+    return Error::success();
+}
+
+// Remove the files listed in the manifest of
+// the previous run which are not in names_,
+// and return how many were removed.
+std::size_t
+OutputFiles::
+removeStale()
+{
+    auto manifest = files::getFileText(manifestPath_);
+    if(! manifest)
+        return 0;
+    std::size_t removed = 0;
+    llvm::SmallVector<llvm::StringRef, 0> previous;
+    llvm::StringRef(*manifest).split(previous, '\n', -1, false);
+    for(auto name : previous)
+    {
+        if(std::binary_search(names_.begin(), names_.end(), name))
+            continue;
+        if(! isRelativeName(name))
+        {
+            report::warn("the manifest \"{}\" lists \"{}\", "
+                "which is not in the output directory",
+                manifestPath_, name.str());
+            continue;
+        }
+        std::string filePath = files::appendPath(outputPath_, name);
+        if(! llvm::sys::fs::remove(filePath, false))
+            ++removed;
+    }
+    return removed;
+}
+
+// Create the directory holding a file, once
+// for all of the files placed in it.
+Error
+OutputFiles::
+createDirectory(
+    std::string_view filePath)
+{
+    llvm::StringRef dir = llvm::sys::path::parent_path(
+        llvm::StringRef(filePath.data(), filePath.size()));
+    if(dir.empty())
+        return Error::success();
+    std::lock_guard<std::mutex> lock(mutex_);
+    if(dirs_.contains(dir))
+        return Error::success();
+    if(auto ec = llvm::sys::fs::create_directories(dir))
+        return formatError("could not create \"{}\": {}", dir.str(), ec);
+    dirs_.insert(dir);
+    return Error::success();
+}
+
+} // mrdox
+} // clang
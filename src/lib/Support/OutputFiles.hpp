@@ -0,0 +1,204 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#ifndef MRDOX_LIB_SUPPORT_OUTPUTFILES_HPP
+#define MRDOX_LIB_SUPPORT_OUTPUTFILES_HPP
+
+#include <mrdox/Platform.hpp>
+#include <mrdox/Config.hpp>
+#include <mrdox/Support/Error.hpp>
+#include <llvm/ADT/StringSet.h>
+#include <llvm/Support/raw_ostream.h>
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+namespace clang {
+namespace mrdox {
+
+/** When written files are flushed to stable storage.
+*/
+enum class FsyncPolicy
+{
+    /** Leave flushing to the operating system.
+    */
+    none,
+
+    /** Flush each file after it is written.
+    */
+    files,
+
+    /** Flush every written file in @ref OutputFiles::finish.
+    */
+    finish
+};
+
+/** Return the fsync policy with the given name.
+*/
+Expected<FsyncPolicy>
+parseFsyncPolicy(
+    std::string_view name);
+
+/** The set of files written by a multi-file generator.
+
+    A file is only written when its contents differ
+    from the file already on disk, so that files
+    which did not change keep their timestamps.
+
+    Files are written behind the caller. @ref write
+    places the file in a bounded queue and returns,
+    and a small set of threads compares, writes, and
+    flushes the queued files. The caller blocks only
+    while the queue is full. Each directory is created
+    once, the first time a file is placed in it.
+
+    The names of the files are kept in a manifest
+    in the output directory. Files listed in the
+    manifest from a previous run which were not
+    written by this run are removed by @ref finish.
+    Files which mrdox did not create are never
+    removed.
+
+    When the configuration enables `archive`, the
+    files are instead appended to a single tar file
+    named `reference.<ext>.tar` by one thread, in
+    the order they are written. The archive is
+    rewritten by every run. An index named
+    `reference.<ext>.tar.index` is written with it,
+    holding one line per file, sorted by name:
+
+    @code
+    <offset> <size> <name>
+    @endcode
+
+    where `offset` is the position of the
+    contents of the file in the archive.
+
+    Switching between the two modes leaves no
+    stale output behind. An archive run removes
+    the files listed in the manifest, and then the
+    manifest, while a run without the archive
+    removes the archive and its index.
+
+    @par Thread Safety
+    @ref write may be called concurrently.
+*/
+class OutputFiles
+{
+    struct File
+    {
+        std::string name;
+        std::string text;
+    };
+
+    struct Entry
+    {
+        std::string name;
+        std::uint64_t offset;
+        std::uint64_t size;
+    };
+
+    std::string outputPath_;
+    std::string ext_;
+    std::string manifestPath_;
+    FsyncPolicy fsync_;
+    std::size_t capacity_;
+    std::mutex mutex_;
+    std::condition_variable queueReady_;
+    std::condition_variable queueSpace_;
+    std::deque<File> queue_;
+    bool stopped_ = false;
+    std::vector<std::thread> threads_;
+    std::vector<std::string> names_;
+    std::vector<std::string> synced_;
+    std::vector<Error> errors_;
+    llvm::StringSet<> dirs_;
+    std::atomic<std::size_t> written_ = 0;
+    std::atomic<std::size_t> unchanged_ = 0;
+    std::string archivePath_;
+    int archiveFd_ = -1;
+    std::unique_ptr<llvm::raw_fd_ostream> archive_;
+    std::vector<Entry> entries_;
+
+public:
+    /** Constructor.
+
+        @param outputPath The directory which
+        holds the files.
+
+        @param ext The extension of the files,
+        without the leading period. This is used
+        to name the manifest, so that generators
+        can share the output directory.
+
+        @param config The configuration, which
+        provides the fsync policy and whether
+        the files are archived.
+    */
+    OutputFiles(
+        std::string_view outputPath,
+        std::string_view ext,
+        Config const& config);
+
+    /** Destructor.
+
+        Files still in the queue are written
+        if @ref finish was not called.
+    */
+    ~OutputFiles();
+
+    /** Queue a file to be written if its contents changed.
+
+        The returned error is the failure of a file
+        queued earlier, if any, so that callers can
+        stop producing output.
+
+        @param fileName The name of the file,
+        relative to the output directory.
+
+        @param text The contents of the file.
+    */
+    Error
+    write(
+        std::string fileName,
+        std::string text);
+
+    /** Write the queued files, remove stale files, and update the manifest.
+
+        The number of files written, unchanged,
+        and removed is reported. When archiving,
+        the archive and its index are completed
+        instead.
+    */
+    Error
+    finish();
+
+private:
+    void stop();
+    void run();
+    Error writeFile(File const& file);
+    Error appendFile(File const& file);
+    Error finishArchive();
+    std::size_t removeStale();
+    Error createDirectory(std::string_view filePath);
+};
+
+} // mrdox
+} // clang
+
+#endif
@@ -257,23 +257,12 @@ public:
 
 //------------------------------------------------
 
-SafeNames::
-SafeNames(
-    llvm::raw_ostream& os,
+llvm::StringMap<std::string>
+makeSafeNames(
     Corpus const& corpus)
-    : corpus_(corpus)
-    //, map_(PrettyBuilder(corpus).map)
-    , map_(UglyBuilder(corpus).map)
-{
-}
-
-SafeNames::
-SafeNames(
-    Corpus const& corpus)
-    : corpus_(corpus)
-    //, map_(PrettyBuilder(corpus).map)
-    , map_(UglyBuilder(corpus).map)
 {
+    //return PrettyBuilder(corpus).map;
+    return UglyBuilder(corpus).map;
 }
 
 llvm::StringRef
@@ -281,6 +270,14 @@ SafeNames::
 get(
     SymbolID const &id) const noexcept
 {
+    auto s = corpus_.getSafeName(id);
+    if(! s.empty())
+        return llvm::StringRef(s.data(), s.size());
+    std::call_once(once_,
+        [&]
+        {
+            map_ = makeSafeNames(corpus_);
+        });
     auto const it = map_.find(llvm::StringRef(id));
     MRDOX_ASSERT(it != map_.end());
     return it->getValue();
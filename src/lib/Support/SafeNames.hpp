@@ -16,6 +16,7 @@
 #include <llvm/ADT/SmallString.h>
 #include <llvm/ADT/StringMap.h>
 #include <llvm/Support/raw_ostream.h>
+#include <mutex>
 #include <string>
 
 namespace clang {
@@ -33,21 +34,24 @@ namespace mrdox {
 class SafeNames
 {
     Corpus const& corpus_;
-    llvm::StringMap<std::string> map_;
-
-    SafeNames(
-        llvm::raw_ostream& os,
-        Corpus const&);
+    mutable std::once_flag once_;
+    mutable llvm::StringMap<std::string> map_;
 
 public:
     /** Constructor.
 
-        Upon construction, the entire table of
-        safe names is built from the corpus.
+        The table of safe names is built once
+        with the corpus, by @ref makeSafeNames.
+        For a corpus which does not store safe
+        names, the table is built here on first
+        use instead.
     */
     explicit
     SafeNames(
-        Corpus const& corpus);
+        Corpus const& corpus) noexcept
+        : corpus_(corpus)
+    {
+    }
 
     llvm::StringRef
     get(SymbolID const& id) const noexcept;
@@ -66,6 +70,14 @@ public:
     }
 };
 
+/** Return the table of safe names for a corpus.
+
+    The table maps each symbol ID to its safe name.
+*/
+llvm::StringMap<std::string>
+makeSafeNames(
+    Corpus const& corpus);
+
 } // mrdox
 } // clang
 
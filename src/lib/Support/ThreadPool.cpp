@@ -9,6 +9,7 @@
 //
 
 #include "lib/Support/Debug.hpp"
+#include "lib/Support/Memory.hpp"
 #include <mrdox/Support/Error.hpp>
 #include <mrdox/Support/ThreadPool.hpp>
 #include <llvm/Support/Signals.h>
@@ -20,6 +21,46 @@
 namespace clang {
 namespace mrdox {
 
+namespace {
+
+// True while the calling thread runs submitted work
+thread_local bool inPoolWork = false;
+
+// Marks the calling thread as running submitted work
+class PoolWork
+{
+    bool prev_;
+
+public:
+    PoolWork() noexcept
+        : prev_(inPoolWork)
+    {
+        inPoolWork = true;
+    }
+
+    ~PoolWork()
+    {
+        inPoolWork = prev_;
+    }
+};
+
+// Return the gate for work submitted by the calling
+// thread. Only work submitted from outside the pool
+// is gated. Work submitted by other work is not,
+// since the submitting work may wait for it while
+// holding its place in the gate, which would never
+// be given up while usage is over the limit.
+MemoryGate*
+gateFor(
+    MemoryGate* gate) noexcept
+{
+    if(inPoolWork)
+        return nullptr;
+    return gate;
+}
+
+} // (anon)
+
 //------------------------------------------------
 //
 // ThreadPool
@@ -56,6 +97,17 @@ getThreadCount() const noexcept
     return 1;
 }
 
+void
+ThreadPool::
+setMemoryLimit(
+    std::size_t bytes)
+{
+    if(bytes != 0)
+        gate_ = std::make_unique<MemoryGate>(bytes);
+    else
+        gate_.reset();
+}
+
 void
 ThreadPool::
 wait()
@@ -72,9 +124,11 @@ post(
     if(impl_)
     {
         impl_->async(
-        [sp = std::make_shared<
+        [gate = gateFor(gate_.get()), sp = std::make_shared<
             any_callable<void(void)>>(std::move(f))]
         {
+            PoolWork work;
+            MemoryGate::Guard guard(gate);
             // do NOT catch exceptions here
             (*sp)();
         });
@@ -98,14 +152,17 @@ struct TaskGroup::
     std::unordered_set<Error> errors;
     std::unique_ptr<
         llvm::ThreadPoolTaskGroup> taskGroup;
+    MemoryGate* gate;
 
     explicit
     Impl(
-        llvm::ThreadPool* threadPool)
+        llvm::ThreadPool* threadPool,
+        MemoryGate* gate_)
         : taskGroup(threadPool
             ? std::make_unique<
                 llvm::ThreadPoolTaskGroup>(*threadPool)
             : nullptr)
+        , gate(gate_)
     {
     }
 };
@@ -119,7 +176,8 @@ TaskGroup::
 TaskGroup(
     ThreadPool& threadPool)
     : impl_(std::make_unique<Impl>(
-        threadPool.impl_.get()))
+        threadPool.impl_.get(),
+        threadPool.gate_.get()))
 {
 }
 
@@ -154,9 +212,11 @@ post(
     if(impl_->taskGroup)
     {
         impl_->taskGroup->async(
-        [&, sp = std::make_shared<
+        [&, gate = gateFor(impl_->gate), sp = std::make_shared<
             any_callable<void(void)>>(std::move(f))]
         {
+            PoolWork work;
+            MemoryGate::Guard guard(gate);
             try
             {
                 (*sp)();
@@ -0,0 +1,233 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#include "lib/-XML/XMLWriter.hpp"
+#include <mrdox/Config.hpp>
+#include <mrdox/Corpus.hpp>
+#include <mrdox/Metadata.hpp>
+#include <mrdox/Support/ThreadPool.hpp>
+#include <test_suite/test_suite.hpp>
+#include <llvm/Support/raw_ostream.h>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace clang {
+namespace mrdox {
+namespace xml {
+
+struct XMLWriter_test
+{
+    struct TestConfig : Config
+    {
+        mutable ThreadPool threadPool_;
+        Settings settings_;
+
+        explicit
+        TestConfig(unsigned concurrency)
+            : threadPool_(concurrency)
+        {
+        }
+
+        ThreadPool&
+        threadPool() const noexcept override
+        {
+            return threadPool_;
+        }
+
+        Settings const&
+        settings() const noexcept override
+        {
+            return settings_;
+        }
+    };
+
+    // A corpus which only finds its symbols
+    struct TestCorpus : Corpus
+    {
+        std::map<SymbolID, std::unique_ptr<Info>> infos_;
+        std::vector<Info const*> index_;
+
+        explicit
+        TestCorpus(
+            Config const& config) noexcept
+            : Corpus(config)
+        {
+        }
+
+        // The IDs sort in the order of insertion,
+        // after the global namespace.
+        template<class T, class P>
+        T&
+        add(
+            std::string name,
+            P& parent)
+        {
+            std::uint8_t bytes[20] = {};
+            auto const n = infos_.size();
+            bytes[18] = static_cast<std::uint8_t>(n >> 8);
+            bytes[19] = static_cast<std::uint8_t>(n);
+            auto I = std::make_unique<T>(SymbolID(bytes));
+            I->Name = std::move(name);
+            I->Namespace.push_back(parent.id);
+            parent.Members.push_back(I->id);
+            auto& result = *I;
+            index_.push_back(I.get());
+            infos_.emplace(I->id, std::move(I));
+            return result;
+        }
+
+        std::vector<Info const*> const&
+        index() const noexcept override
+        {
+            return index_;
+        }
+
+        Info const*
+        find(SymbolID const& id) const noexcept override
+        {
+            auto it = infos_.find(id);
+            if(it == infos_.end())
+                return nullptr;
+            return it->second.get();
+        }
+    };
+
+    // A writer which writes the symbols
+    // without the prolog or the index
+    struct Writer : XMLWriter
+    {
+        Writer(
+            llvm::raw_ostream& os,
+            Corpus const& corpus)
+            : XMLWriter(os, corpus)
+        {
+            options_.prolog = false;
+        }
+    };
+
+    static
+    std::unique_ptr<TypeInfo>
+    builtin(std::string_view name)
+    {
+        auto T = std::make_unique<BuiltinTypeInfo>();
+        T->Name = name;
+        return T;
+    }
+
+    /*  Namespaces holding several windows of
+        symbols of each kind, records with members,
+        and a nested namespace between them.
+    */
+    static
+    void
+    build(TestCorpus& corpus)
+    {
+        auto G = std::make_unique<NamespaceInfo>();
+        auto& global = *G;
+        corpus.index_.push_back(G.get());
+        corpus.infos_.emplace(G->id, std::move(G));
+
+        for(int i = 0; i < 3; ++i)
+        {
+            auto& N = corpus.add<NamespaceInfo>(
+                "N" + std::to_string(i), global);
+            for(int j = 0; j < 600; ++j)
+            {
+                std::string const name =
+                    "s" + std::to_string(j);
+                if(j == 300)
+                {
+                    auto& inner = corpus.add<NamespaceInfo>("inner", N);
+                    auto& f = corpus.add<FunctionInfo>("g", inner);
+                    f.ReturnType = builtin("void");
+                }
+                switch(j % 5)
+                {
+                case 0:
+                {
+                    auto& R = corpus.add<RecordInfo>(name, N);
+                    auto& x = corpus.add<FieldInfo>("x", R);
+                    x.Type = builtin("int");
+                    x.Access = AccessKind::Public;
+                    auto& f = corpus.add<FunctionInfo>("f", R);
+                    f.ReturnType = builtin("int");
+                    f.Access = AccessKind::Public;
+                    break;
+                }
+                case 1:
+                {
+                    auto& f = corpus.add<FunctionInfo>(name, N);
+                    f.ReturnType = builtin("void");
+                    f.Params.emplace_back(builtin("char"), "c", "");
+                    break;
+                }
+                case 2:
+                {
+                    auto& E = corpus.add<EnumInfo>(name, N);
+                    E.Members.emplace_back("a");
+                    E.Members.emplace_back("b");
+                    break;
+                }
+                case 3:
+                {
+                    auto& T = corpus.add<TypedefInfo>(name, N);
+                    T.Type = builtin("long");
+                    break;
+                }
+                case 4:
+                {
+                    auto& V = corpus.add<VariableInfo>(name, N);
+                    V.Type = builtin("double");
+                    break;
+                }
+                }
+            }
+        }
+    }
+
+    static
+    std::string
+    write(unsigned concurrency)
+    {
+        TestConfig config(concurrency);
+        TestCorpus corpus(config);
+        build(corpus);
+        std::string s;
+        llvm::raw_string_ostream os(s);
+        Writer writer(os, corpus);
+        BOOST_TEST(! writer.writeSymbols().failed());
+        return s;
+    }
+
+    // The symbols written in parallel are
+    // the same as the ones written serially
+    void run()
+    {
+        std::string const serial = write(1);
+        BOOST_TEST(serial.find("name=\"inner\"") != std::string::npos);
+        BOOST_TEST(serial.find("name=\"s599\"") != std::string::npos);
+        for(unsigned concurrency : { 2u, 4u })
+        {
+            std::string const parallel = write(concurrency);
+            BOOST_TEST_EQ(parallel.size(), serial.size());
+            BOOST_TEST(parallel == serial);
+        }
+    }
+};
+
+TEST_SUITE(
+    XMLWriter_test,
+    "clang.mrdox.XMLWriter");
+
+} // xml
+} // mrdox
+} // clang
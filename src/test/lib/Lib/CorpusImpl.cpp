@@ -0,0 +1,199 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#include "lib/AST/Bitcode.hpp"
+#include "lib/Lib/ConfigImpl.hpp"
+#include "lib/Lib/CorpusImpl.hpp"
+#include "lib/Support/SafeNames.hpp"
+#include <mrdox/Metadata.hpp>
+#include <mrdox/Support/ThreadPool.hpp>
+#include <test_suite/test_suite.hpp>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/MemoryBuffer.h>
+#include <llvm/Support/raw_ostream.h>
+#include <algorithm>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace clang {
+namespace mrdox {
+
+struct CorpusImpl_test
+{
+    static
+    SymbolID
+    makeID(std::uint8_t n)
+    {
+        std::uint8_t bytes[20] = {};
+        bytes[19] = n;
+        return SymbolID(bytes);
+    }
+
+    /*  namespace N { struct A; void f(); }
+    */
+    static
+    std::vector<std::unique_ptr<Info>>
+    makeInfos()
+    {
+        std::vector<std::unique_ptr<Info>> infos;
+        auto G = std::make_unique<NamespaceInfo>();
+        auto N = std::make_unique<NamespaceInfo>(makeID(1));
+        auto A = std::make_unique<RecordInfo>(makeID(2));
+        auto f = std::make_unique<FunctionInfo>(makeID(3));
+        N->Name = "N";
+        N->Namespace = { G->id };
+        G->Members = { N->id };
+        A->Name = "A";
+        A->Namespace = { N->id, G->id };
+        f->Name = "f";
+        f->Namespace = { N->id, G->id };
+        N->Members = { A->id, f->id };
+
+        f->javadoc = std::make_unique<Javadoc>();
+        doc::Paragraph para;
+        para.emplace_back(f->javadoc->arena(), doc::Text("brief"));
+        f->javadoc->emplace_back(std::move(para));
+
+        // not in ID order
+        infos.emplace_back(std::move(f));
+        infos.emplace_back(std::move(A));
+        infos.emplace_back(std::move(G));
+        infos.emplace_back(std::move(N));
+        return infos;
+    }
+
+    static
+    std::string
+    tempPath()
+    {
+        llvm::SmallString<128> path;
+        if(llvm::sys::fs::createTemporaryFile(
+                "mrdox-corpus", "snapshot", path))
+            return {};
+        return std::string(path);
+    }
+
+    // A snapshot loads as the corpus it was saved from
+    void
+    testRoundTrip(
+        std::shared_ptr<ConfigImpl const> const& config)
+    {
+        auto corpus = CorpusImpl::build(makeInfos(), config);
+        if(! BOOST_TEST(corpus.has_value()))
+            return;
+
+        // The safe names are stored when the corpus
+        // is finalized, and do not change afterwards
+        {
+            auto const map = makeSafeNames(**corpus);
+            for(Info const* I : (*corpus)->index())
+            {
+                auto it = map.find(llvm::StringRef(I->id));
+                if(BOOST_TEST(it != map.end()))
+                    BOOST_TEST_EQ((*corpus)->getSafeName(I->id),
+                        it->getValue().str());
+            }
+        }
+
+        auto const path = tempPath();
+        if(! BOOST_TEST(! path.empty()))
+            return;
+        BOOST_TEST(! (*corpus)->save(path).failed());
+
+        auto loaded = CorpusImpl::load(path, config);
+        if(BOOST_TEST(loaded.has_value()))
+        {
+            Corpus const& c0 = **corpus;
+            Corpus const& c1 = **loaded;
+            BOOST_TEST_EQ(c0.index().size(), 4);
+            if(BOOST_TEST_EQ(c0.index().size(), c1.index().size()))
+            {
+                // Compare symbol by symbol
+                for(std::size_t i = 0; i < c0.index().size(); ++i)
+                {
+                    Info const& I0 = *c0.index()[i];
+                    Info const& I1 = *c1.index()[i];
+                    BOOST_TEST(I0.id == I1.id);
+                    BOOST_TEST(writeBitcode(I0).data ==
+                        writeBitcode(I1).data);
+                }
+            }
+
+            // The content hashes are read from the
+            // snapshot, and match the ones computed
+            auto const& hashes = static_cast<
+                CorpusImpl const&>(c1).contentHashes();
+            BOOST_TEST(hashes == (*corpus)->contentHashes());
+            BOOST_TEST(hashes.size() == 4 && hashes[2] != hashes[3]);
+        }
+
+        // A table which is out of order is rejected.
+        // The second and third entries are swapped.
+        {
+            auto file = llvm::MemoryBuffer::getFile(path);
+            if(BOOST_TEST(file) && BOOST_TEST(
+                (*file)->getBufferSize() > 24 + 3 * 48))
+            {
+                std::string data((*file)->getBuffer());
+                file->reset();
+                std::swap_ranges(
+                    data.begin() + 24 + 48,
+                    data.begin() + 24 + 96,
+                    data.begin() + 24 + 96);
+                std::error_code ec;
+                {
+                    llvm::raw_fd_ostream os(path, ec);
+                    os << data;
+                }
+                BOOST_TEST(! ec);
+                BOOST_TEST(! CorpusImpl::load(path, config).has_value());
+            }
+        }
+        llvm::sys::fs::remove(path);
+    }
+
+    // A symbol ID may only appear once
+    void
+    testDuplicate(
+        std::shared_ptr<ConfigImpl const> const& config)
+    {
+        auto infos = makeInfos();
+        auto I = std::make_unique<RecordInfo>(makeID(2));
+        I->Name = "B";
+        infos.emplace_back(std::move(I));
+        auto corpus = CorpusImpl::build(std::move(infos), config);
+        if(BOOST_TEST(! corpus.has_value()))
+            BOOST_TEST(corpus.error().reason().find(
+                "duplicate symbol") != std::string::npos);
+    }
+
+    void run()
+    {
+        ThreadPool threadPool(2);
+        auto config = createConfig(
+            MRDOX_TEST_FILES_DIR,
+            MRDOX_TEST_FILES_DIR,
+            "",
+            threadPool);
+        if(! BOOST_TEST(config.has_value()))
+            return;
+        testRoundTrip(*config);
+        testDuplicate(*config);
+    }
+};
+
+TEST_SUITE(
+    CorpusImpl_test,
+    "clang.mrdox.CorpusImpl");
+
+} // mrdox
+} // clang
@@ -0,0 +1,191 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#include "lib/Lib/NameIndex.hpp"
+#include <mrdox/Config.hpp>
+#include <mrdox/Corpus.hpp>
+#include <mrdox/Metadata.hpp>
+#include <mrdox/Support/ThreadPool.hpp>
+#include <test_suite/test_suite.hpp>
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+
+namespace clang {
+namespace mrdox {
+
+struct NameIndex_test
+{
+    struct TestConfig : Config
+    {
+        mutable ThreadPool threadPool_;
+        Settings settings_;
+
+        TestConfig()
+            : threadPool_(2)
+        {
+        }
+
+        ThreadPool&
+        threadPool() const noexcept override
+        {
+            return threadPool_;
+        }
+
+        Settings const&
+        settings() const noexcept override
+        {
+            return settings_;
+        }
+    };
+
+    // A corpus which only finds its symbols
+    struct TestCorpus : Corpus
+    {
+        std::map<SymbolID, std::unique_ptr<Info>> infos_;
+        std::vector<Info const*> index_;
+
+        explicit
+        TestCorpus(
+            Config const& config) noexcept
+            : Corpus(config)
+        {
+        }
+
+        // The IDs sort in the order of insertion
+        template<class T>
+        T&
+        add(
+            std::string_view name,
+            Info const* parent = nullptr)
+        {
+            std::uint8_t bytes[20] = {};
+            bytes[19] = static_cast<std::uint8_t>(infos_.size() + 1);
+            auto I = std::make_unique<T>(SymbolID(bytes));
+            I->Name = name;
+            if(parent)
+                I->Namespace.push_back(parent->id);
+            auto& result = *I;
+            index_.push_back(I.get());
+            infos_.emplace(I->id, std::move(I));
+            return result;
+        }
+
+        std::vector<Info const*> const&
+        index() const noexcept override
+        {
+            return index_;
+        }
+
+        Info const*
+        find(SymbolID const& id) const noexcept override
+        {
+            auto it = infos_.find(id);
+            if(it == infos_.end())
+                return nullptr;
+            return it->second.get();
+        }
+    };
+
+    // Return the names of the symbols found,
+    // separated by spaces
+    static
+    std::string
+    names(std::vector<Info const*> const& list)
+    {
+        std::string s;
+        for(auto const* I : list)
+        {
+            if(! s.empty())
+                s.push_back(' ');
+            s.append(I->Name);
+        }
+        return s;
+    }
+
+    /*  namespace N
+        {
+            void f(int);
+            struct Foo;
+            void f(double);
+            struct foo;
+            void fooBar();
+        }
+    */
+    void run()
+    {
+        TestConfig config;
+        TestCorpus corpus(config);
+        auto const& N = corpus.add<NamespaceInfo>("N");
+        auto const& f0 = corpus.add<FunctionInfo>("f", &N);
+        corpus.add<RecordInfo>("Foo", &N);
+        auto const& f1 = corpus.add<FunctionInfo>("f", &N);
+        corpus.add<RecordInfo>("foo", &N);
+        corpus.add<FunctionInfo>("fooBar", &N);
+
+        NameIndex index;
+        BOOST_TEST(! index.built());
+        if(! BOOST_TEST(! index.build(corpus.index(),
+                corpus, config.threadPool()).failed()))
+            return;
+        BOOST_TEST(index.built());
+        BOOST_TEST_EQ(index.name(0), "N");
+        BOOST_TEST_EQ(index.name(1), "N::f");
+
+        // Overloads are found together,
+        // in the order of the index
+        {
+            auto found = index.find("N::f", false);
+            if(BOOST_TEST_EQ(found.size(), 2))
+            {
+                BOOST_TEST(found[0] == &f0);
+                BOOST_TEST(found[1] == &f1);
+            }
+            BOOST_TEST_EQ(index.find("n::F", false).size(), 0);
+            BOOST_TEST_EQ(index.find("n::F", true).size(), 2);
+            BOOST_TEST_EQ(index.find("N::g", true).size(), 0);
+        }
+
+        // Names which differ only in case
+        BOOST_TEST_EQ(names(index.find("N::Foo", false)), "Foo");
+        BOOST_TEST_EQ(names(index.find("N::foo", false)), "foo");
+        BOOST_TEST_EQ(names(index.find("n::FOO", true)), "Foo foo");
+
+        // Prefixes
+        BOOST_TEST_EQ(names(index.findPrefix("N::foo", false, 10)),
+            "foo fooBar");
+        BOOST_TEST_EQ(names(index.findPrefix("N::Foo", false, 10)),
+            "Foo");
+        BOOST_TEST_EQ(names(index.findPrefix("n::FOO", true, 10)),
+            "Foo foo fooBar");
+        BOOST_TEST_EQ(names(index.findPrefix("N::f", false, 10)),
+            "f f foo fooBar");
+        BOOST_TEST_EQ(names(index.findPrefix("N::", true, 10)),
+            "f f Foo foo fooBar");
+        BOOST_TEST_EQ(names(index.findPrefix("", true, 10)),
+            "N f f Foo foo fooBar");
+        BOOST_TEST_EQ(names(index.findPrefix("N::x", true, 10)), "");
+
+        // The limit is applied after matching
+        BOOST_TEST_EQ(names(index.findPrefix("n::f", true, 3)),
+            "f f Foo");
+        BOOST_TEST_EQ(names(index.findPrefix("N::f", false, 3)),
+            "f f foo");
+        BOOST_TEST_EQ(index.findPrefix("N", true, 0).size(), 0);
+    }
+};
+
+TEST_SUITE(
+    NameIndex_test,
+    "clang.mrdox.NameIndex");
+
+} // mrdox
+} // clang
@@ -0,0 +1,143 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#include "lib/Lib/XRefIndex.hpp"
+#include <mrdox/Metadata.hpp>
+#include <mrdox/Support/ThreadPool.hpp>
+#include <test_suite/test_suite.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace clang {
+namespace mrdox {
+
+struct XRefIndex_test
+{
+    std::vector<std::unique_ptr<Info>> infos_;
+    std::vector<Info const*> index_;
+
+    // The IDs sort in the order of insertion
+    template<class T>
+    T&
+    add(std::string_view name)
+    {
+        std::uint8_t bytes[20] = {};
+        bytes[19] = static_cast<std::uint8_t>(infos_.size() + 1);
+        auto I = std::make_unique<T>(SymbolID(bytes));
+        I->Name = name;
+        auto& result = *I;
+        index_.push_back(I.get());
+        infos_.emplace_back(std::move(I));
+        return result;
+    }
+
+    static
+    std::unique_ptr<TypeInfo>
+    tag(Info const& I)
+    {
+        auto T = std::make_unique<TagTypeInfo>();
+        T->Name = I.Name;
+        T->id = I.id;
+        return T;
+    }
+
+    static
+    std::unique_ptr<TypeInfo>
+    pointer(Info const& I)
+    {
+        auto T = std::make_unique<PointerTypeInfo>();
+        T->PointeeType = tag(I);
+        return T;
+    }
+
+    // Return the names of the symbols which
+    // refer to a symbol, separated by spaces
+    std::string
+    refs(
+        XRefIndex const& xrefs,
+        Info const& I,
+        XRefKind kind)
+    {
+        std::size_t i = 0;
+        while(i < index_.size() && index_[i] != &I)
+            ++i;
+        std::string s;
+        for(auto const* R : xrefs.find(i, kind))
+        {
+            if(! s.empty())
+                s.push_back(' ');
+            s.append(R->Name);
+        }
+        return s;
+    }
+
+    /*  struct A;
+        struct B : A { friend A; };
+        void f(A, A, B*);
+        struct C : A, B {};
+        A x;
+        template<> struct A<int>;
+        typedef A* P;
+    */
+    void run()
+    {
+        auto& A = add<RecordInfo>("A");
+        auto& B = add<RecordInfo>("B");
+        B.Bases.emplace_back(tag(A), AccessKind::Public, false);
+        B.Friends.push_back(A.id);
+        auto& f = add<FunctionInfo>("f");
+        f.Params.emplace_back(tag(A), "", "");
+        f.Params.emplace_back(tag(A), "", "");
+        f.Params.emplace_back(pointer(B), "", "");
+        auto& C = add<RecordInfo>("C");
+        C.Bases.emplace_back(tag(A), AccessKind::Public, false);
+        C.Bases.emplace_back(tag(B), AccessKind::Public, false);
+        auto& x = add<VariableInfo>("x");
+        x.Type = tag(A);
+        auto& S = add<RecordInfo>("S");
+        S.Template = std::make_unique<TemplateInfo>();
+        S.Template->Primary.emplace() = A.id;
+        auto& P = add<TypedefInfo>("P");
+        P.Type = pointer(A);
+
+        XRefIndex xrefs;
+        BOOST_TEST(xrefs.find(0, XRefKind::Derived).empty());
+
+        ThreadPool threadPool(2);
+        if(! BOOST_TEST(! xrefs.build(index_, threadPool).failed()))
+            return;
+
+        // Each relation is reversed, and the symbols
+        // which refer to another are in index order
+        BOOST_TEST_EQ(refs(xrefs, A, XRefKind::Derived), "B C");
+        BOOST_TEST_EQ(refs(xrefs, B, XRefKind::Derived), "C");
+        BOOST_TEST_EQ(refs(xrefs, C, XRefKind::Derived), "");
+        BOOST_TEST_EQ(refs(xrefs, A, XRefKind::FriendOf), "B");
+        BOOST_TEST_EQ(refs(xrefs, B, XRefKind::FriendOf), "");
+        BOOST_TEST_EQ(refs(xrefs, A, XRefKind::Specializations), "S");
+
+        // A type named more than once by a
+        // symbol is only referenced once
+        BOOST_TEST_EQ(refs(xrefs, A, XRefKind::ReferencedBy), "f x P");
+        BOOST_TEST_EQ(refs(xrefs, B, XRefKind::ReferencedBy), "f");
+        BOOST_TEST_EQ(refs(xrefs, f, XRefKind::ReferencedBy), "");
+
+        // A position past the end has no references
+        BOOST_TEST(xrefs.find(index_.size(), XRefKind::Derived).empty());
+    }
+};
+
+TEST_SUITE(
+    XRefIndex_test,
+    "clang.mrdox.XRefIndex");
+
+} // mrdox
+} // clang
@@ -0,0 +1,255 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#include "lib/Metadata/Interface.hpp"
+#include <mrdox/Config.hpp>
+#include <mrdox/Corpus.hpp>
+#include <mrdox/Metadata.hpp>
+#include <mrdox/Support/ThreadPool.hpp>
+#include <test_suite/test_suite.hpp>
+#include <algorithm>
+#include <map>
+#include <memory>
+#include <string_view>
+
+namespace clang {
+namespace mrdox {
+
+struct Interface_test
+{
+    struct TestConfig : Config
+    {
+        mutable ThreadPool threadPool_;
+        Settings settings_;
+
+        TestConfig()
+            : threadPool_(2)
+        {
+        }
+
+        ThreadPool&
+        threadPool() const noexcept override
+        {
+            return threadPool_;
+        }
+
+        Settings const&
+        settings() const noexcept override
+        {
+            return settings_;
+        }
+    };
+
+    // A corpus which only finds its symbols
+    struct TestCorpus : Corpus
+    {
+        std::map<SymbolID, std::unique_ptr<Info>> infos_;
+        std::vector<Info const*> index_;
+
+        explicit
+        TestCorpus(
+            Config const& config) noexcept
+            : Corpus(config)
+        {
+        }
+
+        template<class T>
+        T&
+        add(
+            std::string_view name,
+            AccessKind access = AccessKind::None)
+        {
+            // The IDs sort in the order of insertion
+            std::uint8_t bytes[20] = {};
+            bytes[19] = static_cast<std::uint8_t>(infos_.size() + 1);
+            auto I = std::make_unique<T>(SymbolID(bytes));
+            I->Name = name;
+            I->Access = access;
+            auto& result = *I;
+            index_.push_back(I.get());
+            infos_.emplace(I->id, std::move(I));
+            return result;
+        }
+
+        std::vector<Info const*> const&
+        index() const noexcept override
+        {
+            return index_;
+        }
+
+        Info const*
+        find(SymbolID const& id) const noexcept override
+        {
+            auto it = infos_.find(id);
+            if(it == infos_.end())
+                return nullptr;
+            return it->second.get();
+        }
+    };
+
+    // Add a member to a record
+    template<class T>
+    static
+    T&
+    member(
+        TestCorpus& corpus,
+        RecordInfo& R,
+        std::string_view name,
+        AccessKind access)
+    {
+        auto& I = corpus.add<T>(name, access);
+        R.Members.push_back(I.id);
+        return I;
+    }
+
+    static
+    void
+    derive(
+        RecordInfo& R,
+        RecordInfo const& base,
+        AccessKind access)
+    {
+        auto T = std::make_unique<TagTypeInfo>();
+        T->Name = base.Name;
+        T->id = base.id;
+        R.Bases.emplace_back(std::move(T), access, false);
+    }
+
+    // Return the names in a list, separated by spaces
+    template<class T>
+    static
+    std::string
+    names(std::span<T const*> list)
+    {
+        std::string s;
+        for(auto const* I : list)
+        {
+            if(! s.empty())
+                s.push_back(' ');
+            s.append(I->Name);
+        }
+        return s;
+    }
+
+    /*  struct A
+        {
+            int a_pub;
+            void g();
+        protected:
+            int a_prot;
+        private:
+            int a_priv;
+            virtual void f();
+        };
+
+        struct B : public A {};
+        struct C : protected A {};
+        struct D : private A {};
+        struct E : public B { void f() override; };
+    */
+    void
+    check(
+        bool includePrivate,
+        bool cached)
+    {
+        TestConfig config;
+        config.settings_.includePrivate = includePrivate;
+        TestCorpus corpus(config);
+
+        auto& A = corpus.add<RecordInfo>("A");
+        member<FieldInfo>(corpus, A, "a_pub", AccessKind::Public);
+        member<FunctionInfo>(corpus, A, "g", AccessKind::Public);
+        member<FieldInfo>(corpus, A, "a_prot", AccessKind::Protected);
+        member<FieldInfo>(corpus, A, "a_priv", AccessKind::Private);
+        member<FunctionInfo>(corpus, A, "f", AccessKind::Private
+            ).specs0.isVirtual = true;
+
+        auto& B = corpus.add<RecordInfo>("B");
+        derive(B, A, AccessKind::Public);
+        auto& C = corpus.add<RecordInfo>("C");
+        derive(C, A, AccessKind::Protected);
+        auto& D = corpus.add<RecordInfo>("D");
+        derive(D, A, AccessKind::Private);
+        auto& E = corpus.add<RecordInfo>("E");
+        derive(E, B, AccessKind::Public);
+        member<FunctionInfo>(corpus, E, "f", AccessKind::Public
+            ).specs0.isVirtual = true;
+
+        InterfaceCache cache(corpus);
+        if(cached && ! BOOST_TEST(! cache.build(
+                corpus.index(), config.threadPool()).failed()))
+            return;
+        auto const get = [&](RecordInfo const& R)
+        {
+            if(cached)
+                return cache.makeInterface(R);
+            return makeInterface(R, corpus);
+        };
+
+        // A public base keeps the access of its members
+        {
+            auto I = get(B);
+            BOOST_TEST_EQ(names(I.Public.Data), "a_pub");
+            BOOST_TEST_EQ(names(I.Protected.Data), "a_prot");
+            BOOST_TEST_EQ(names(I.Private.Data),
+                includePrivate ? "a_priv" : "");
+            BOOST_TEST_EQ(names(I.Public.Functions), "g");
+            BOOST_TEST_EQ(names(I.Private.Functions), "f");
+        }
+
+        // A protected base makes public members protected
+        {
+            auto I = get(C);
+            BOOST_TEST_EQ(names(I.Public.Data), "");
+            BOOST_TEST_EQ(names(I.Protected.Data), "a_pub a_prot");
+            BOOST_TEST_EQ(names(I.Protected.Functions), "g");
+            BOOST_TEST_EQ(names(I.Private.Functions), "f");
+        }
+
+        // A private base is only listed with private members,
+        // and then all of its members are private
+        {
+            auto I = get(D);
+            BOOST_TEST_EQ(names(I.Public.Data), "");
+            BOOST_TEST_EQ(names(I.Protected.Data), "");
+            BOOST_TEST_EQ(names(I.Private.Data),
+                includePrivate ? "a_pub a_prot a_priv" : "");
+            BOOST_TEST_EQ(names(I.Private.Functions),
+                includePrivate ? "g f" : "");
+        }
+
+        // The overrider and the private virtual are both listed
+        {
+            auto I = get(E);
+            BOOST_TEST_EQ(names(I.Public.Data), "a_pub");
+            BOOST_TEST_EQ(names(I.Protected.Data), "a_prot");
+            BOOST_TEST_EQ(names(I.Public.Functions), "g f");
+            BOOST_TEST_EQ(names(I.Private.Functions), "f");
+            if( I.Public.Functions.size() == 2 &&
+                I.Private.Functions.size() == 1)
+                BOOST_TEST(I.Public.Functions[1] != I.Private.Functions[0]);
+        }
+    }
+
+    void run()
+    {
+        check(false, false);
+        check(true, false);
+        check(false, true);
+        check(true, true);
+    }
+};
+
+TEST_SUITE(
+    Interface_test,
+    "clang.mrdox.Interface");
+
+} // mrdox
+} // clang
@@ -0,0 +1,185 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#include <mrdox/Metadata/Javadoc.hpp>
+#include <test_suite/test_suite.hpp>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace clang {
+namespace mrdox {
+
+struct Javadoc_test
+{
+    static inline std::atomic<int> parses_ = 0;
+    static inline std::vector<std::string> blockCommands_;
+
+    // A parser which makes one paragraph
+    // holding the text of the comment
+    static
+    Javadoc
+    parseText(doc::RawText const& raw)
+    {
+        ++parses_;
+        blockCommands_ = raw.blockCommands;
+        Javadoc jd;
+        doc::Paragraph para;
+        para.emplace_back(jd.arena(),
+            doc::Text(std::string(raw.text)));
+        jd.emplace_back(std::move(para));
+        return jd;
+    }
+
+    // A parser which makes no nodes
+    static
+    Javadoc
+    parseNothing(doc::RawText const&)
+    {
+        ++parses_;
+        return {};
+    }
+
+    void
+    testParsePending()
+    {
+        parses_ = 0;
+        Javadoc jd;
+        jd.appendRaw("/// a", &parseText);
+        jd.appendRaw("/// a", &parseText);
+        jd.appendRaw("/// b", &parseText);
+        BOOST_TEST_EQ(jd.getParsedBlocks().size(), 0);
+        BOOST_TEST_EQ(jd.getPending().size(), 2);
+        BOOST_TEST_EQ(parses_.load(), 0);
+
+        // the non-const overload parses too
+        BOOST_TEST_EQ(jd.getBlocks().size(), 2);
+        BOOST_TEST_EQ(parses_.load(), 2);
+        BOOST_TEST(jd.getPending().empty());
+
+        // comments are parsed once
+        Javadoc const& cjd = jd;
+        BOOST_TEST_EQ(cjd.getBlocks().size(), 2);
+        BOOST_TEST(! cjd.empty());
+        BOOST_TEST_EQ(parses_.load(), 2);
+
+        // the parser receives the options
+        // the comment was read with
+        Javadoc jd1;
+        jd1.appendRaw(doc::RawText{ "/// c", 1, { "par" } }, &parseText);
+        BOOST_TEST_EQ(jd1.getBlocks().size(), 1);
+        BOOST_TEST(blockCommands_ == std::vector<std::string>{ "par" });
+
+        // a comment which parses to nothing is empty
+        Javadoc jd2;
+        jd2.appendRaw("//", &parseNothing);
+        BOOST_TEST(jd2.empty());
+        BOOST_TEST_EQ(parses_.load(), 4);
+    }
+
+    void
+    testCompare()
+    {
+        parses_ = 0;
+        Javadoc jd0;
+        Javadoc jd1;
+        Javadoc jd2;
+        jd0.appendRaw("/// a", &parseText);
+        jd1.appendRaw("/// a", &parseText);
+        jd2.appendRaw("/// b", &parseText);
+
+        // the same pending comments are
+        // equal without parsing them
+        BOOST_TEST(jd0 == jd1);
+        BOOST_TEST_EQ(parses_.load(), 0);
+
+        // otherwise the parsed nodes are compared
+        BOOST_TEST(jd0 != jd2);
+        BOOST_TEST_EQ(parses_.load(), 2);
+
+        // a pending comment equals
+        // the same comment parsed
+        BOOST_TEST(jd0 == jd1);
+        BOOST_TEST(jd1 == jd0);
+        BOOST_TEST_EQ(parses_.load(), 3);
+
+        // a clone keeps the parser
+        Javadoc jd3;
+        jd3.appendRaw("/// b", &parseText);
+        Javadoc jd4 = jd3.clone();
+        BOOST_TEST_EQ(jd4.getBlocks().size(), 1);
+        BOOST_TEST_EQ(parses_.load(), 4);
+        BOOST_TEST(jd4 == jd2);
+
+        // pending comments with the same
+        // hash also compare their text
+        Javadoc jd5;
+        Javadoc jd6;
+        jd5.appendRaw(doc::RawText{ "/// a", 1 }, &parseText);
+        jd6.appendRaw(doc::RawText{ "/// b", 1 }, &parseText);
+        BOOST_TEST(jd5 != jd6);
+    }
+
+    void
+    testShared()
+    {
+        parses_ = 0;
+        auto shared = std::make_shared<Javadoc const>(
+            parseText(doc::RawText{ "/// a" }));
+
+        // the nodes are not copied
+        Javadoc jd0(shared);
+        Javadoc jd1 = jd0.clone();
+        BOOST_TEST(&jd0.getParsedBlocks() == &shared->getParsedBlocks());
+        BOOST_TEST(&jd1.getParsedBlocks() == &shared->getParsedBlocks());
+        BOOST_TEST(jd0 == jd1);
+        BOOST_TEST(jd0 == *shared);
+
+        // changing a javadoc copies the nodes first
+        jd1.append(parseText(doc::RawText{ "/// b" }));
+        BOOST_TEST(&jd1.getParsedBlocks() != &shared->getParsedBlocks());
+        BOOST_TEST_EQ(jd1.getBlocks().size(), 2);
+        BOOST_TEST_EQ(shared->getBlocks().size(), 1);
+        BOOST_TEST(jd0 != jd1);
+    }
+
+    void
+    testTraverse()
+    {
+        Javadoc jd;
+        doc::Paragraph para;
+        para.emplace_back(jd.arena(), doc::Text("a"));
+        para.emplace_back(jd.arena(), doc::Text("b"));
+        std::string s;
+        doc::traverse(para.children,
+            [&]<class T>(T const& t)
+            {
+                if constexpr(std::is_same_v<T, doc::Text>)
+                    s.append(t.string);
+            });
+        BOOST_TEST_EQ(s, "ab");
+    }
+
+    void run()
+    {
+        testParsePending();
+        testCompare();
+        testShared();
+        testTraverse();
+    }
+};
+
+TEST_SUITE(
+    Javadoc_test,
+    "clang.mrdox.Javadoc");
+
+} // mrdox
+} // clang
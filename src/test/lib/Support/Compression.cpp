@@ -0,0 +1,158 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#include "lib/Support/Compression.hpp"
+#include <mrdox/Support/Path.hpp>
+#include <test_suite/test_suite.hpp>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Program.h>
+#include <llvm/Support/raw_ostream.h>
+#include <sstream>
+#include <string>
+
+namespace clang {
+namespace mrdox {
+
+struct Compression_test
+{
+    // Text which does not compress to nothing
+    static
+    std::string
+    makeText(std::size_t size)
+    {
+        std::string s;
+        s.reserve(size);
+        std::uint32_t x = 1;
+        while(s.size() < size)
+        {
+            x = x * 1103515245 + 12345;
+            s.push_back(static_cast<char>('a' + (x >> 16) % 26));
+            if((x >> 8) % 16 == 0)
+                s.push_back('\n');
+        }
+        s.resize(size);
+        return s;
+    }
+
+    static
+    std::string
+    compress(
+        std::string const& text,
+        Compression compression)
+    {
+        std::ostringstream dest;
+        {
+            CompressedOstream os(dest, compression);
+            os.write(text.data(), text.size());
+            BOOST_TEST(! os.close().failed());
+        }
+        return dest.str();
+    }
+
+    // Decompress with the standard tool, if it is
+    // installed. Return false if it is not.
+    static
+    bool
+    decompressWithTool(
+        std::string const& data,
+        Compression compression,
+        std::string& text)
+    {
+        char const* const name =
+            compression == Compression::gzip ? "gzip" : "zstd";
+        auto program = llvm::sys::findProgramByName(name);
+        if(! program)
+            return false;
+
+        llvm::SmallString<128> inPath;
+        llvm::SmallString<128> outPath;
+        if(! BOOST_TEST(! llvm::sys::fs::createTemporaryFile(
+                "mrdox-compressed", "bin", inPath)) ||
+            ! BOOST_TEST(! llvm::sys::fs::createTemporaryFile(
+                "mrdox-decompressed", "txt", outPath)))
+            return false;
+        {
+            std::error_code ec;
+            llvm::raw_fd_ostream os(inPath, ec);
+            BOOST_TEST(! ec);
+            os << data;
+        }
+        llvm::StringRef const args[] = {
+            *program, "-d", "-c", "-q", inPath };
+        int const rv = llvm::sys::ExecuteAndWait(
+            *program, args, {}, { {}, outPath.str(), {} });
+        BOOST_TEST_EQ(rv, 0);
+        auto result = files::getFileText(outPath.str());
+        if(BOOST_TEST(result))
+            text = std::move(*result);
+        llvm::sys::fs::remove(inPath);
+        llvm::sys::fs::remove(outPath);
+        return true;
+    }
+
+    void
+    check(
+        std::string const& text,
+        Compression compression)
+    {
+        std::string const data = compress(text, compression);
+        BOOST_TEST(! data.empty());
+
+        auto result = decompress(data, compression);
+        if(BOOST_TEST(result))
+        {
+            BOOST_TEST_EQ(result->size(), text.size());
+            BOOST_TEST(*result == text);
+        }
+
+        std::string fromTool;
+        if(decompressWithTool(data, compression, fromTool))
+        {
+            BOOST_TEST_EQ(fromTool.size(), text.size());
+            BOOST_TEST(fromTool == text);
+        }
+    }
+
+    void
+    testCompression(Compression compression)
+    {
+        if(requireCompression(compression))
+            return;
+
+        // Empty text
+        check({}, compression);
+
+        // One block
+        check("Hello, world!\n", compression);
+        check(makeText(1000), compression);
+
+        // Several blocks, which wrap around the ring
+        check(makeText(5 * 1024 * 1024 + 123), compression);
+    }
+
+    void run()
+    {
+        BOOST_TEST(getCompression("a.xml.gz") == Compression::gzip);
+        BOOST_TEST(getCompression("a.xml.zst") == Compression::zstd);
+        BOOST_TEST(getCompression("a.xml") == Compression::none);
+        BOOST_TEST_EQ(stripCompression("a.xml.gz"), "a.xml");
+
+        testCompression(Compression::gzip);
+        testCompression(Compression::zstd);
+    }
+};
+
+TEST_SUITE(
+    Compression_test,
+    "clang.mrdox.Compression");
+
+} // mrdox
+} // clang
@@ -0,0 +1,141 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#include "lib/Lib/ConfigImpl.hpp"
+#include "lib/Lib/CorpusImpl.hpp"
+#include <mrdox/Generator.hpp>
+#include <mrdox/Support/ThreadPool.hpp>
+#include <test_suite/test_suite.hpp>
+#include <fmt/format.h>
+#include <atomic>
+#include <stdexcept>
+
+namespace clang {
+namespace mrdox {
+
+struct Generator_test
+{
+    // A generator which only counts its builds
+    struct TestGenerator : Generator
+    {
+        std::string_view id_;
+        bool fail_;
+        bool throw_;
+        mutable std::atomic<int> builds_ = 0;
+
+        TestGenerator(
+            std::string_view id,
+            bool fail,
+            bool throws = false) noexcept
+            : id_(id)
+            , fail_(fail)
+            , throw_(throws)
+        {
+        }
+
+        std::string_view id() const noexcept override { return id_; }
+        std::string_view displayName() const noexcept override { return id_; }
+        std::string_view fileExtension() const noexcept override { return id_; }
+
+        Error
+        build(
+            std::string_view,
+            Corpus const&) const override
+        {
+            ++builds_;
+            if(throw_)
+                throw std::runtime_error(fmt::format("{} threw", id_));
+            if(fail_)
+                return formatError("{} failed", id_);
+            return Error::success();
+        }
+
+        Error
+        buildOne(
+            std::ostream&,
+            Corpus const&) const override
+        {
+            return Error::success();
+        }
+    };
+
+    void
+    testBuildAll()
+    {
+        ThreadPool threadPool(2);
+        auto config = createConfig(
+            MRDOX_TEST_FILES_DIR,
+            MRDOX_TEST_FILES_DIR,
+            "",
+            threadPool);
+        if(! BOOST_TEST(config.has_value()))
+            return;
+        CorpusImpl corpus(*config);
+
+        // Two formats which both succeed
+        {
+            TestGenerator g0("one", false);
+            TestGenerator g1("two", false);
+            auto err = buildAll({ &g0, &g1 }, "", corpus);
+            BOOST_TEST(! err.failed());
+            BOOST_TEST_EQ(g0.builds_.load(), 1);
+            BOOST_TEST_EQ(g1.builds_.load(), 1);
+        }
+
+        // Only the failure is reported
+        {
+            TestGenerator g0("one", false);
+            TestGenerator g1("two", true);
+            auto err = buildAll({ &g0, &g1 }, "", corpus);
+            BOOST_TEST(err.failed());
+            BOOST_TEST_EQ(err.reason(), "two failed");
+        }
+
+        // Both failures are reported
+        {
+            TestGenerator g0("one", true);
+            TestGenerator g1("two", true);
+            auto err = buildAll({ &g0, &g1 }, "", corpus);
+            BOOST_TEST(err.failed());
+            BOOST_TEST(err.reason().find("2 errors occurred") !=
+                std::string::npos);
+        }
+
+        // An exception is reported as a failure,
+        // and the other format is still built
+        {
+            TestGenerator g0("one", false);
+            TestGenerator g1("two", false, true);
+            auto err = buildAll({ &g0, &g1 }, "", corpus);
+            BOOST_TEST(err.failed());
+            BOOST_TEST_EQ(err.reason(), "two threw");
+            BOOST_TEST_EQ(g0.builds_.load(), 1);
+        }
+
+        // Also when there is only one format
+        {
+            TestGenerator g0("one", false, true);
+            auto err = buildAll({ &g0 }, "", corpus);
+            BOOST_TEST_EQ(err.reason(), "one threw");
+        }
+    }
+
+    void run()
+    {
+        testBuildAll();
+    }
+};
+
+TEST_SUITE(
+    Generator_test,
+    "clang.mrdox.Generator");
+
+} // mrdox
+} // clang
@@ -0,0 +1,230 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#include "lib/Support/OutputFiles.hpp"
+#include <mrdox/Config.hpp>
+#include <mrdox/Support/Path.hpp>
+#include <mrdox/Support/ThreadPool.hpp>
+#include <test_suite/test_suite.hpp>
+#include <llvm/ADT/SmallString.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/raw_ostream.h>
+#include <string>
+
+namespace clang {
+namespace mrdox {
+
+struct OutputFiles_test
+{
+    struct TestConfig : Config
+    {
+        mutable ThreadPool threadPool_;
+        Settings settings_;
+
+        TestConfig()
+            : threadPool_(2)
+        {
+        }
+
+        ThreadPool&
+        threadPool() const noexcept override
+        {
+            return threadPool_;
+        }
+
+        Settings const&
+        settings() const noexcept override
+        {
+            return settings_;
+        }
+    };
+
+    std::string dir_;
+
+    bool
+    exists(std::string_view name)
+    {
+        return llvm::sys::fs::exists(
+            files::appendPath(dir_, name));
+    }
+
+    std::string
+    text(std::string_view name)
+    {
+        auto text = files::getFileText(
+            files::appendPath(dir_, name));
+        if(! text)
+            return {};
+        return *text;
+    }
+
+    // Write the files of one run
+    void
+    generate(
+        bool archive,
+        std::initializer_list<std::string_view> names)
+    {
+        TestConfig config;
+        config.settings_.archive = archive;
+        OutputFiles files(dir_, "txt", config);
+        for(auto name : names)
+            BOOST_TEST(! files.write(std::string(name),
+                "text of " + std::string(name)).failed());
+        BOOST_TEST(! files.finish().failed());
+    }
+
+    // Files from the previous run are removed,
+    // but files which mrdox did not write are kept.
+    void
+    testManifest()
+    {
+        generate(false, { "a.txt", "d/b.txt" });
+        BOOST_TEST_EQ(text("a.txt"), "text of a.txt");
+        BOOST_TEST_EQ(text("d/b.txt"), "text of d/b.txt");
+        BOOST_TEST_EQ(text(".mrdox-txt.manifest"), "a.txt\nd/b.txt\n");
+
+        {
+            std::error_code ec;
+            llvm::raw_fd_ostream os(
+                files::appendPath(dir_, "user.txt"), ec);
+            os << "mine";
+            BOOST_TEST(! ec);
+        }
+        generate(false, { "a.txt" });
+        BOOST_TEST(exists("a.txt"));
+        BOOST_TEST(! exists("d/b.txt"));
+        BOOST_TEST(exists("user.txt"));
+        BOOST_TEST_EQ(text(".mrdox-txt.manifest"), "a.txt\n");
+    }
+
+    // A name longer than the header holds is
+    // written to a PAX extended header, and the
+    // index gives the position of each file.
+    void
+    testArchive()
+    {
+        std::string const longName =
+            std::string(120, 'x') + ".txt";
+        generate(true, { "c.txt", longName, "a.txt" });
+        std::string tar = text("reference.txt.tar");
+        BOOST_TEST_EQ(tar.size() % 512, 0);
+
+        // The loose files and the manifest
+        // of the previous run are removed
+        BOOST_TEST(! exists("a.txt"));
+        BOOST_TEST(! exists(".mrdox-txt.manifest"));
+        BOOST_TEST(exists("user.txt"));
+
+        // c.txt, then the extended header
+        if(BOOST_TEST(tar.size() > 4 * 512))
+        {
+            llvm::StringRef h(tar.data() + 1024, 512);
+            BOOST_TEST(h.startswith("PaxHeader"));
+            BOOST_TEST_EQ(h[156], 'x');
+            llvm::StringRef record(tar.data() + 1536, 512);
+            BOOST_TEST(record.contains(" path=" + longName + "\n"));
+            llvm::StringRef h1(tar.data() + 2048, 512);
+            BOOST_TEST_EQ(h1[156], '0');
+            BOOST_TEST(h1.startswith(longName.substr(0, 100)));
+        }
+
+        // One line per file, sorted by name
+        std::string index = text("reference.txt.tar.index");
+        llvm::SmallVector<llvm::StringRef, 0> lines;
+        llvm::StringRef(index).split(lines, '\n', -1, false);
+        if(BOOST_TEST_EQ(lines.size(), 3))
+        {
+            std::string_view const names[] = {
+                "a.txt", "c.txt", longName };
+            for(std::size_t i = 0; i < 3; ++i)
+            {
+                auto [offset, rest] = lines[i].split(' ');
+                auto [size, name] = rest.split(' ');
+                BOOST_TEST_EQ(name.str(), names[i]);
+                std::size_t n0 = 0;
+                std::size_t n1 = 0;
+                BOOST_TEST(! offset.getAsInteger(10, n0));
+                BOOST_TEST(! size.getAsInteger(10, n1));
+                if(BOOST_TEST(n0 + n1 <= tar.size()))
+                    BOOST_TEST_EQ(tar.substr(n0, n1),
+                        "text of " + std::string(names[i]));
+            }
+        }
+
+        // A run without the archive removes it
+        generate(false, { "a.txt" });
+        BOOST_TEST(! exists("reference.txt.tar"));
+        BOOST_TEST(! exists("reference.txt.tar.index"));
+        BOOST_TEST(exists("a.txt"));
+    }
+
+    // The error from creating the output directory
+    // is returned by write, and again by finish.
+    void
+    testUnwritable()
+    {
+        // A file stands where a directory is needed
+        std::string const file = files::appendPath(dir_, "file");
+        {
+            std::error_code ec;
+            llvm::raw_fd_ostream os(file, ec);
+            BOOST_TEST(! ec);
+        }
+        auto const check = [&](std::string const& outputPath)
+        {
+            TestConfig config;
+            config.settings_.archive = true;
+            OutputFiles files(outputPath, "txt", config);
+            auto err = files.write("a.txt", "text of a.txt");
+            if(BOOST_TEST(err.failed()))
+                BOOST_TEST(err.reason().find(
+                    "could not create") != std::string::npos);
+            BOOST_TEST(files.finish().failed());
+            BOOST_TEST(! llvm::sys::fs::exists(
+                files::appendPath(outputPath, "reference.txt.tar")));
+        };
+        check(files::appendPath(file, "out"));
+
+        // A directory without write permission. The
+        // check is skipped when permissions are not
+        // enforced, as for the superuser.
+        std::string const locked = files::appendPath(dir_, "locked");
+        namespace fs = llvm::sys::fs;
+        if(BOOST_TEST(! fs::create_directory(locked)) &&
+            BOOST_TEST(! fs::setPermissions(locked,
+                fs::owner_read | fs::owner_exe)))
+        {
+            if(fs::access(locked, fs::AccessMode::Write))
+                check(files::appendPath(locked, "out"));
+            fs::setPermissions(locked, fs::all_all);
+        }
+    }
+
+    void run()
+    {
+        llvm::SmallString<128> dir;
+        if(! BOOST_TEST(! llvm::sys::fs::createUniqueDirectory(
+                "mrdox-output", dir)))
+            return;
+        dir_ = std::string(dir);
+        testManifest();
+        testArchive();
+        testUnwritable();
+        llvm::sys::fs::remove_directories(dir_);
+    }
+};
+
+TEST_SUITE(
+    OutputFiles_test,
+    "clang.mrdox.OutputFiles");
+
+} // mrdox
+} // clang
@@ -0,0 +1,187 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#include "lib/Support/SafeNames.hpp"
+#include <mrdox/Config.hpp>
+#include <mrdox/Corpus.hpp>
+#include <mrdox/Metadata.hpp>
+#include <mrdox/Support/ThreadPool.hpp>
+#include <test_suite/test_suite.hpp>
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/ADT/StringSet.h>
+#include <map>
+#include <memory>
+#include <string_view>
+
+namespace clang {
+namespace mrdox {
+
+struct SafeNames_test
+{
+    struct TestConfig : Config
+    {
+        mutable ThreadPool threadPool_;
+        Settings settings_;
+
+        TestConfig()
+            : threadPool_(2)
+        {
+        }
+
+        ThreadPool&
+        threadPool() const noexcept override
+        {
+            return threadPool_;
+        }
+
+        Settings const&
+        settings() const noexcept override
+        {
+            return settings_;
+        }
+    };
+
+    // A corpus which only finds its symbols
+    struct TestCorpus : Corpus
+    {
+        std::map<SymbolID, std::unique_ptr<Info>> infos_;
+        std::vector<Info const*> index_;
+
+        explicit
+        TestCorpus(
+            Config const& config) noexcept
+            : Corpus(config)
+        {
+        }
+
+        template<class T>
+        T&
+        add(
+            std::uint8_t n,
+            std::string_view name,
+            Info const* parent = nullptr)
+        {
+            std::uint8_t bytes[20] = {};
+            bytes[19] = n;
+            auto I = std::make_unique<T>(SymbolID(bytes));
+            I->Name = name;
+            if(parent)
+                I->Namespace.push_back(parent->id);
+            auto& result = *I;
+            index_.push_back(I.get());
+            infos_.emplace(I->id, std::move(I));
+            return result;
+        }
+
+        std::vector<Info const*> const&
+        index() const noexcept override
+        {
+            return index_;
+        }
+
+        Info const*
+        find(SymbolID const& id) const noexcept override
+        {
+            auto it = infos_.find(id);
+            if(it == infos_.end())
+                return nullptr;
+            return it->second.get();
+        }
+    };
+
+    /*  namespace N
+        {
+            struct Foo;
+            struct foo;
+            void f(int);
+            void f(double);
+        }
+
+        The members are added in reverse when
+        `reversed` is true, to check that the names
+        do not depend on the order of the index.
+    */
+    static
+    void
+    build(
+        TestCorpus& corpus,
+        bool reversed)
+    {
+        auto const& N = corpus.add<NamespaceInfo>(1, "N");
+        std::pair<std::uint8_t, std::string_view> const symbols[] = {
+            { 2, "Foo" }, { 3, "foo" }, { 4, "f" }, { 5, "f" } };
+        for(std::size_t i = 0; i < 4; ++i)
+        {
+            auto const& s = symbols[reversed ? 3 - i : i];
+            if(s.second == "f")
+                corpus.add<FunctionInfo>(s.first, s.second, &N);
+            else
+                corpus.add<RecordInfo>(s.first, s.second, &N);
+        }
+    }
+
+    void run()
+    {
+        TestConfig config;
+        TestCorpus corpus(config);
+        build(corpus, false);
+        auto const map = makeSafeNames(corpus);
+        BOOST_TEST_EQ(map.size(), corpus.index().size());
+
+        // Unique without regard to case, and only
+        // characters valid in filenames and URLs
+        llvm::StringSet<> seen;
+        for(Info const* I : corpus.index())
+        {
+            auto it = map.find(llvm::StringRef(I->id));
+            if(! BOOST_TEST(it != map.end()))
+                continue;
+            llvm::StringRef s = it->getValue();
+            BOOST_TEST(! s.empty());
+            BOOST_TEST(seen.insert(s.lower()).second);
+            BOOST_TEST(llvm::all_of(s,
+                [](char c)
+                {
+                    return llvm::isAlnum(c) || c == '-' || c == '_';
+                }));
+        }
+
+        // Stable across builds and orders of the index
+        BOOST_TEST(makeSafeNames(corpus) == map);
+        {
+            TestCorpus other(config);
+            build(other, true);
+            BOOST_TEST(makeSafeNames(other) == map);
+        }
+
+        // A corpus which does not store safe names
+        // gets the ones of the table
+        SafeNames names(corpus);
+        for(Info const* I : corpus.index())
+        {
+            auto it = map.find(llvm::StringRef(I->id));
+            if(BOOST_TEST(it != map.end()))
+                BOOST_TEST_EQ(names.get(I->id).str(), it->getValue());
+        }
+        auto path = names.getPath(corpus.index()[1]->id);
+        if(BOOST_TEST_EQ(path.size(), 2))
+        {
+            BOOST_TEST_EQ(path[0], names.get(corpus.index()[1]->id));
+            BOOST_TEST_EQ(path[1], names.get(corpus.index()[0]->id));
+        }
+    }
+};
+
+TEST_SUITE(
+    SafeNames_test,
+    "clang.mrdox.SafeNames");
+
+} // mrdox
+} // clang
@@ -0,0 +1,81 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#include <mrdox/Support/ThreadPool.hpp>
+#include <test_suite/test_suite.hpp>
+#include <atomic>
+
+namespace clang {
+namespace mrdox {
+
+struct ThreadPool_test
+{
+    // Work which waits for work it submitted
+    // completes, even when memory usage is
+    // always over the limit.
+    void
+    testNestedUnderLimit()
+    {
+        ThreadPool threadPool(4);
+        threadPool.setMemoryLimit(1);
+
+        std::atomic<int> count = 0;
+        TaskGroup outer(threadPool);
+        for(int i = 0; i < 8; ++i)
+        {
+            outer.async(
+                [&]
+                {
+                    TaskGroup inner(threadPool);
+                    for(int j = 0; j < 8; ++j)
+                    {
+                        inner.async(
+                            [&]
+                            {
+                                ++count;
+                            });
+                    }
+                    BOOST_TEST(inner.wait().empty());
+                });
+        }
+        BOOST_TEST(outer.wait().empty());
+        BOOST_TEST_EQ(count.load(), 64);
+
+        // Work submitted directly to the pool
+        for(int i = 0; i < 4; ++i)
+        {
+            threadPool.async(
+                [&]
+                {
+                    TaskGroup inner(threadPool);
+                    inner.async(
+                        [&]
+                        {
+                            ++count;
+                        });
+                    BOOST_TEST(inner.wait().empty());
+                });
+        }
+        threadPool.wait();
+        BOOST_TEST_EQ(count.load(), 68);
+    }
+
+    void run()
+    {
+        testNestedUnderLimit();
+    }
+};
+
+TEST_SUITE(
+    ThreadPool_test,
+    "clang.mrdox.ThreadPool");
+
+} // mrdox
+} // clang
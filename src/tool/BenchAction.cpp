@@ -0,0 +1,233 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#include "ToolArgs.hpp"
+#include "lib/Lib/ConfigImpl.hpp"
+#include "lib/Lib/CorpusImpl.hpp"
+#include <mrdox/Generators.hpp>
+#include <mrdox/Support/Error.hpp>
+#include <mrdox/Support/ThreadPool.hpp>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringRef.h>
+#include <fmt/format.h>
+#include <chrono>
+#include <memory>
+#include <sstream>
+#include <string>
+
+namespace clang {
+namespace mrdox {
+
+extern
+Expected<std::unique_ptr<Corpus>>
+buildCorpus(
+    std::shared_ptr<ConfigImpl const> const& config);
+
+namespace {
+
+/*  The ways the templates are rendered. The
+    settings go under the generator's key.
+*/
+struct Variant
+{
+    std::string_view name;
+    std::string_view settings;
+};
+
+constexpr Variant variants[] = {
+    { "js",             "engine: js\n    eager-fields: 0\n" },
+    { "js, eager",      "engine: js\n" },
+    { "native",         "engine: native\n" } };
+
+/*  A corpus which has the symbols of another
+    corpus and a different configuration. This
+    lets every variant render the same symbols,
+    which are built or loaded only once.
+*/
+class ConfiguredCorpus : public Corpus
+{
+    Corpus const& corpus_;
+    std::shared_ptr<ConfigImpl const> config_;
+
+public:
+    ConfiguredCorpus(
+        Corpus const& corpus,
+        std::shared_ptr<ConfigImpl const> config) noexcept
+        : Corpus(*config)
+        , corpus_(corpus)
+        , config_(std::move(config))
+    {
+    }
+
+private:
+    std::vector<Info const*> const&
+    index() const noexcept override
+    {
+        return corpus_.index();
+    }
+
+    Info const*
+    find(
+        SymbolID const& id) const noexcept override
+    {
+        return corpus_.find(id);
+    }
+
+    std::vector<Info const*>
+    findByName(
+        std::string_view name,
+        bool ignoreCase) const override
+    {
+        return corpus_.findByName(name, ignoreCase);
+    }
+
+    std::vector<Info const*>
+    findByPrefix(
+        std::string_view prefix,
+        bool ignoreCase,
+        std::size_t limit) const override
+    {
+        return corpus_.findByPrefix(prefix, ignoreCase, limit);
+    }
+
+    Interface const*
+    findInterface(
+        RecordInfo const& I) const noexcept override
+    {
+        return corpus_.findInterface(I);
+    }
+
+    NamespaceOverloads const*
+    findOverloads(
+        NamespaceInfo const& I) const noexcept override
+    {
+        return corpus_.findOverloads(I);
+    }
+
+    std::span<Info const* const>
+    findXRefs(
+        Info const& I,
+        XRefKind kind) const noexcept override
+    {
+        return corpus_.findXRefs(I, kind);
+    }
+
+    std::string_view
+    getSafeName(
+        SymbolID const& id) const noexcept override
+    {
+        return corpus_.getSafeName(id);
+    }
+
+    std::string_view
+    qualifiedName(
+        Info const& I) const noexcept override
+    {
+        return corpus_.qualifiedName(I);
+    }
+};
+
+/*  Render the single page reference with one
+    variant, and return the elapsed time.
+*/
+Expected<std::chrono::milliseconds>
+renderWith(
+    std::string& text,
+    Corpus const& corpus,
+    Generator const& generator,
+    Variant const& variant,
+    ThreadPool& threadPool)
+{
+    auto config = loadConfigFile(
+        toolArgs.configPath,
+        toolArgs.addonsDir,
+        fmt::format("generator:\n  {}:\n    {}",
+            generator.id(), variant.settings),
+        nullptr,
+        threadPool);
+    if(! config)
+        return config.error();
+    ConfiguredCorpus configured(corpus, *config);
+
+    std::ostringstream os;
+    auto const t0 = std::chrono::steady_clock::now();
+    if(auto err = generator.buildOne(os, configured))
+        return err;
+    auto const t1 = std::chrono::steady_clock::now();
+    text = std::move(os).str();
+    return std::chrono::duration_cast<
+        std::chrono::milliseconds>(t1 - t0);
+}
+
+} // (anon)
+
+Error
+DoBenchAction()
+{
+    ThreadPool threadPool(toolArgs.concurrency);
+
+    if(toolArgs.configPath.empty())
+        return formatError("the config path argument is missing");
+
+    // The symbols are built or loaded once,
+    // and every variant renders them.
+    std::string extraYaml;
+    if(toolArgs.ignoreMappingFailures.getValue())
+        extraYaml = "ignore-failures: true\n";
+    auto config = loadConfigFile(
+        toolArgs.configPath,
+        toolArgs.addonsDir,
+        extraYaml,
+        nullptr,
+        threadPool);
+    if(! config)
+        return config.error();
+    auto corpus = toolArgs.loadCorpus.empty()
+        ? buildCorpus(*config)
+        : CorpusImpl::load(toolArgs.loadCorpus.getValue(), *config);
+    if(! corpus)
+        return corpus.error();
+
+    llvm::SmallVector<llvm::StringRef, 4> parts;
+    llvm::StringRef(toolArgs.formatType.getValue()).split(
+        parts, ',', -1, false);
+    for(auto part : parts)
+    {
+        auto const format = part.trim();
+        if(format != "adoc" && format != "html")
+            return formatError("the Generator \"{}\" has no template engine", format.str());
+        auto generator = getGenerators().find(format);
+        if(! generator)
+            return formatError("the Generator \"{}\" was not found", format.str());
+
+        // Every variant renders the same symbols,
+        // and must produce the same output.
+        std::string first;
+        for(auto const& variant : variants)
+        {
+            std::string text;
+            auto ms = renderWith(
+                text, **corpus, *generator, variant, threadPool);
+            if(! ms)
+                return ms.error();
+            report::info("{}, {}: {} ms",
+                generator->displayName(), variant.name, ms->count());
+            if(&variant == &variants[0])
+                first = std::move(text);
+            else if(text != first)
+                return formatError("the {} output with {} differs",
+                    generator->displayName(), variant.name);
+        }
+    }
+    return Error::success();
+}
+
+} // mrdox
+} // clang
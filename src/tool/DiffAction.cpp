@@ -0,0 +1,90 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#include "ToolArgs.hpp"
+#include "lib/Lib/ConfigImpl.hpp"
+#include "lib/Lib/CorpusDiff.hpp"
+#include "lib/Lib/CorpusImpl.hpp"
+#include <mrdox/Support/Error.hpp>
+#include <mrdox/Support/Path.hpp>
+#include <llvm/Support/raw_ostream.h>
+
+namespace clang {
+namespace mrdox {
+
+extern
+Expected<std::unique_ptr<Corpus>>
+buildCorpus(
+    std::shared_ptr<ConfigImpl const> const& config);
+
+Error
+DoDiffAction()
+{
+    ThreadPool threadPool(toolArgs.concurrency);
+
+    if(toolArgs.diffBase.empty())
+        return formatError("the --base snapshot is missing");
+    auto const& format = toolArgs.diffFormat.getValue();
+    if(format != "json" && format != "xml")
+        return formatError("the diff format \"{}\" is not json or xml", format);
+
+    // Load configuration file
+    if(toolArgs.configPath.empty())
+        return formatError("the config path argument is missing");
+    auto config = loadConfigFile(
+        toolArgs.configPath,
+        toolArgs.addonsDir,
+        toolArgs.ignoreMappingFailures.getValue() ?
+            "ignore-failures: true\n" : "",
+        nullptr,
+        threadPool);
+    if(! config)
+        return config.error();
+
+    // The old symbols always come from a snapshot,
+    // the new ones from a snapshot or a fresh run.
+    auto before = CorpusImpl::load(toolArgs.diffBase.getValue(), *config);
+    if(! before)
+        return before.error();
+    auto after = toolArgs.loadCorpus.empty()
+        ? buildCorpus(*config)
+        : CorpusImpl::load(toolArgs.loadCorpus.getValue(), *config);
+    if(! after)
+        return after.error();
+
+    auto diff = diffCorpus(
+        static_cast<CorpusImpl const&>(**before),
+        static_cast<CorpusImpl const&>(**after));
+    if(! diff)
+        return diff.error();
+    report::info("{} added, {} removed, {} changed",
+        diff->added.size(), diff->removed.size(), diff->changed.size());
+
+    // Write to stdout when no output file is given
+    std::error_code ec;
+    std::string outputPath = "-";
+    if(toolArgs.outputPath.getNumOccurrences() != 0 &&
+        toolArgs.outputPath.getValue() != "-")
+        outputPath = files::normalizePath(toolArgs.outputPath.getValue());
+    llvm::raw_fd_ostream os(outputPath, ec);
+    if(ec)
+        return formatError("could not open \"{}\": {}", outputPath, ec);
+    if(format == "json")
+        writeDiffJSON(os, *diff, **before, **after);
+    else
+        writeDiffXML(os, *diff, **before, **after);
+    os.flush();
+    if(os.has_error())
+        return formatError("could not write \"{}\": {}", outputPath, os.error());
+    return Error::success();
+}
+
+} // mrdox
+} // clang
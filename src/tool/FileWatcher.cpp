@@ -0,0 +1,128 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#include "FileWatcher.hpp"
+#include <llvm/Support/FileSystem.h>
+#include <thread>
+
+namespace clang {
+namespace mrdox {
+
+void
+FileWatcher::
+add(
+    llvm::StringRef path,
+    Filter filter)
+{
+    roots_.push_back({ path.str(), std::move(filter) });
+    stamps_ = scan();
+}
+
+llvm::StringMap<FileWatcher::Stamp>
+FileWatcher::
+scan() const
+{
+    namespace fs = llvm::sys::fs;
+
+    llvm::StringMap<Stamp> stamps;
+    auto insert = [&](
+        llvm::StringRef path,
+        fs::basic_file_status const& st)
+    {
+        stamps[path] = {
+            st.getLastModificationTime(),
+            st.getSize() };
+    };
+    for(auto const& root : roots_)
+    {
+        fs::file_status st;
+        if(fs::status(root.path, st))
+            continue;
+        if(! fs::is_directory(st))
+        {
+            insert(root.path, st);
+            continue;
+        }
+        std::error_code ec;
+        for(fs::recursive_directory_iterator it(root.path, ec), end;
+            it != end && ! ec; it.increment(ec))
+        {
+            if(it->type() == fs::file_type::directory_file)
+                continue;
+            if(root.filter && ! root.filter(it->path()))
+                continue;
+            auto status = it->status();
+            if(status)
+                insert(it->path(), *status);
+        }
+    }
+    return stamps;
+}
+
+// Scan the files, add the paths which differ
+// from the last scan, and return true if any did.
+bool
+FileWatcher::
+update(
+    llvm::StringSet<>& changed)
+{
+    auto stamps = scan();
+    bool found = false;
+    for(auto const& e : stamps)
+    {
+        auto it = stamps_.find(e.getKey());
+        if(it == stamps_.end() || !(it->second == e.getValue()))
+        {
+            changed.insert(e.getKey());
+            found = true;
+        }
+    }
+    for(auto const& e : stamps_)
+    {
+        if(! stamps.count(e.getKey()))
+        {
+            changed.insert(e.getKey());
+            found = true;
+        }
+    }
+    stamps_ = std::move(stamps);
+    return found;
+}
+
+std::vector<std::string>
+FileWatcher::
+wait(
+    std::chrono::milliseconds interval,
+    std::chrono::milliseconds settle)
+{
+    llvm::StringSet<> changed;
+    do
+    {
+        std::this_thread::sleep_for(interval);
+    }
+    while(! update(changed));
+
+    // Wait for the burst of writes from an editor
+    // or build to settle, keeping what it changed.
+    do
+    {
+        std::this_thread::sleep_for(settle);
+    }
+    while(update(changed));
+
+    std::vector<std::string> result;
+    result.reserve(changed.size());
+    for(auto const& e : changed)
+        result.emplace_back(e.getKey());
+    return result;
+}
+
+} // mrdox
+} // clang
@@ -0,0 +1,104 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#ifndef MRDOX_TOOL_FILEWATCHER_HPP
+#define MRDOX_TOOL_FILEWATCHER_HPP
+
+#include <llvm/ADT/StringMap.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/ADT/StringSet.h>
+#include <llvm/Support/Chrono.h>
+#include <chrono>
+#include <functional>
+#include <string>
+#include <vector>
+
+namespace clang {
+namespace mrdox {
+
+/** Detects changes to a set of files and directories.
+
+    The watched paths are polled for changes in
+    their modification time and size, which works
+    the same on every platform and on network
+    file systems where change notifications
+    are not delivered.
+*/
+class FileWatcher
+{
+public:
+    using Filter = std::function<bool(llvm::StringRef)>;
+
+    /** Add a file, or a directory and everything in it.
+
+        @param path The path to watch.
+
+        @param filter An optional predicate. When
+        watching a directory, only files for which
+        the predicate returns `true` are watched.
+    */
+    void
+    add(
+        llvm::StringRef path,
+        Filter filter = {});
+
+    /** Block until a watched file changes.
+
+        Files which are added, removed, or modified
+        are all considered changes. After a change
+        is seen, the files are scanned again every
+        `settle` interval until a scan finds nothing
+        new, and every change found along the way
+        is returned together.
+
+        @return The paths of the changed files.
+
+        @param interval The time between scans
+        while nothing is changing.
+
+        @param settle The time between scans
+        while changes are arriving.
+    */
+    std::vector<std::string>
+    wait(
+        std::chrono::milliseconds interval =
+            std::chrono::milliseconds(200),
+        std::chrono::milliseconds settle =
+            std::chrono::milliseconds(100));
+
+private:
+    struct Root
+    {
+        std::string path;
+        Filter filter;
+    };
+
+    struct Stamp
+    {
+        llvm::sys::TimePoint<> time;
+        std::uint64_t size = 0;
+
+        bool operator==(Stamp const&) const noexcept = default;
+    };
+
+    llvm::StringMap<Stamp> scan() const;
+
+    bool
+    update(
+        llvm::StringSet<>& changed);
+
+    std::vector<Root> roots_;
+    llvm::StringMap<Stamp> stamps_;
+};
+
+} // mrdox
+} // clang
+
+#endif
@@ -9,26 +9,90 @@
 // Official repository: https://github.com/cppalliance/mrdox
 //
 
+#include "FileWatcher.hpp"
 #include "ToolArgs.hpp"
 #include "lib/Lib/AbsoluteCompilationDatabase.hpp"
 #include "lib/Lib/ConfigImpl.hpp"
 #include "lib/Lib/CorpusImpl.hpp"
 #include "lib/Lib/ToolExecutor.hpp"
+#include "lib/Support/Memory.hpp"
 #include <mrdox/Generators.hpp>
 #include <mrdox/Support/Error.hpp>
 #include <mrdox/Support/Path.hpp>
 #include <clang/Tooling/JSONCompilationDatabase.h>
+#include <llvm/ADT/SmallVector.h>
+#include <llvm/ADT/StringRef.h>
+#include <llvm/Support/FileSystem.h>
+#include <llvm/Support/Path.h>
+#include <llvm/Support/raw_ostream.h>
+#include <algorithm>
 #include <cstdlib>
+#include <vector>
 
 namespace clang {
 namespace mrdox {
 
+Expected<std::unique_ptr<Corpus>>
+buildCorpus(
+    std::shared_ptr<ConfigImpl const> const& config)
+{
+    // Load the compilation database
+    if(toolArgs.inputPaths.empty())
+        return formatError("the compilation database path argument is missing");
+    if(toolArgs.inputPaths.size() > 1)
+        return formatError("got {} input paths where 1 was expected", toolArgs.inputPaths.size());
+    auto compilationsPath = files::normalizePath(toolArgs.inputPaths.front());
+    std::string errorMessage;
+    auto jsonCompilations = tooling::JSONCompilationDatabase::loadFromFile(
+        compilationsPath, errorMessage, tooling::JSONCommandLineSyntax::AutoDetect);
+    if(! jsonCompilations)
+        return Error(std::move(errorMessage));
+
+    // Calculate the working directory
+    auto absPath = files::makeAbsolute(compilationsPath);
+    if(! absPath)
+        return absPath.error();
+    auto workingDir = files::getParentDir(*absPath);
+
+    // Convert relative paths to absolute
+    AbsoluteCompilationDatabase compilations(
+        workingDir, *jsonCompilations, config);
+
+    // Create the ToolExecutor from the compilation database
+    auto ex = std::make_unique<ToolExecutor>(
+        report::Level::info, *config, compilations);
+
+    auto corpus = CorpusImpl::build(*ex, config);
+    if(! corpus)
+        return formatError("CorpusImpl::build returned \"{}\"", corpus.error());
+    return corpus;
+}
+
+/*  Run the generators. When there is more than
+    one, each runs on its own thread and they
+    share the thread pool for their work.
+*/
+static
+Error
+generateDocs(
+    std::vector<Generator const*> const& selected,
+    Corpus const& corpus)
+{
+    report::info("Generating docs\n");
+    return buildAll(selected, toolArgs.outputPath.getValue(), corpus);
+}
+
 Error
 DoGenerateAction()
 {
     auto& generators = getGenerators();
 
     ThreadPool threadPool(toolArgs.concurrency);
+    if(toolArgs.memoryLimit.getValue() != 0)
+        threadPool.setMemoryLimit(
+            std::size_t(toolArgs.memoryLimit.getValue()) << 20);
+    if(! toolArgs.memoryReport.empty())
+        memoryReport().enable();
 
     // Calculate additional YAML settings from command line options.
     std::string extraYaml;
@@ -41,33 +105,19 @@ DoGenerateAction()
     // Load configuration file
     if(toolArgs.configPath.empty())
         return formatError("the config path argument is missing");
-    auto config = loadConfigFile(
-        toolArgs.configPath,
-        toolArgs.addonsDir,
-        extraYaml,
-        nullptr,
-        threadPool);
+    auto loadConfig = [&]
+    {
+        return loadConfigFile(
+            toolArgs.configPath,
+            toolArgs.addonsDir,
+            extraYaml,
+            nullptr,
+            threadPool);
+    };
+    auto config = loadConfig();
     if(! config)
         return config.error();
 
-    // Load the compilation database
-    if(toolArgs.inputPaths.empty())
-        return formatError("the compilation database path argument is missing");
-    if(toolArgs.inputPaths.size() > 1)
-        return formatError("got {} input paths where 1 was expected", toolArgs.inputPaths.size());
-    auto compilationsPath = files::normalizePath(toolArgs.inputPaths.front());
-    std::string errorMessage;
-    auto jsonCompilations = tooling::JSONCompilationDatabase::loadFromFile(
-        compilationsPath, errorMessage, tooling::JSONCommandLineSyntax::AutoDetect);
-    if(! jsonCompilations)
-        return Error(std::move(errorMessage));
-
-    // Calculate the working directory
-    auto absPath = files::makeAbsolute(compilationsPath);
-    if(! absPath)
-        return absPath.error();
-    auto workingDir = files::getParentDir(*absPath);
-
     // normalize outputPath
     if( toolArgs.outputPath.empty())
         return formatError("output path is empty");
@@ -75,28 +125,155 @@ DoGenerateAction()
         files::makeAbsolute(toolArgs.outputPath,
             (**config)->workingDir));
 
-    // Convert relative paths to absolute
-    AbsoluteCompilationDatabase compilations(
-        workingDir, *jsonCompilations, *config);
-
-    // Create the ToolExecutor from the compilation database
-    auto ex = std::make_unique<ToolExecutor>(
-        report::Level::info, **config, compilations);
-
-    // Create the generator
-    auto generator = generators.find(toolArgs.formatType.getValue());
-    if(! generator)
-        return formatError("the Generator \"{}\" was not found",
-            toolArgs.formatType.getValue());
+    // Create the generators. The formats come from
+    // --format, which may be a comma separated list,
+    // or from the configuration when not specified.
+    std::vector<std::string> formats;
+    if(toolArgs.formatType.getNumOccurrences() == 0 &&
+        ! (**config)->generate.empty())
+    {
+        formats = (**config)->generate;
+    }
+    else
+    {
+        llvm::SmallVector<llvm::StringRef, 4> parts;
+        llvm::StringRef(toolArgs.formatType.getValue()).split(
+            parts, ',', -1, false);
+        for(auto part : parts)
+            formats.emplace_back(part.trim().str());
+    }
+    std::vector<Generator const*> selected;
+    for(auto const& format : formats)
+    {
+        auto generator = generators.find(format);
+        if(! generator)
+            return formatError("the Generator \"{}\" was not found", format);
+        selected.push_back(generator);
+    }
+    if(selected.empty())
+        return formatError("no output format was specified");
 
     // Run the tool, this can take a while
-    auto corpus = CorpusImpl::build(*ex, *config);
+    auto corpus = toolArgs.loadCorpus.empty()
+        ? buildCorpus(*config)
+        : CorpusImpl::load(toolArgs.loadCorpus.getValue(), *config);
     if(! corpus)
-        return formatError("CorpusImpl::build returned \"{}\"", corpus.error());
+        return corpus.error();
 
-    // Run the generator.
-    report::info("Generating docs\n");
-    return generator->build(toolArgs.outputPath.getValue(), **corpus);
+    auto saveCorpus = [&](Corpus const& result)
+    {
+        if(toolArgs.saveCorpus.empty())
+            return Error::success();
+        report::info("Saving corpus to \"{}\"", toolArgs.saveCorpus.getValue());
+        return static_cast<CorpusImpl const&>(result).save(
+            toolArgs.saveCorpus.getValue());
+    };
+    if(auto err = saveCorpus(**corpus))
+        return err;
+
+    Error err = generateDocs(selected, **corpus);
+    memoryReport().record("generate");
+    if(memoryReport().enabled())
+    {
+        report::print(report::Level::info, memoryReport().toTable());
+        std::error_code ec;
+        llvm::raw_fd_ostream os(toolArgs.memoryReport.getValue(), ec);
+        if(ec)
+            return formatError("could not write the memory report to \"{}\": {}",
+                toolArgs.memoryReport.getValue(), ec);
+        os << memoryReport().toJSON();
+    }
+    if(! toolArgs.watch.getValue())
+        return err;
+    if(err)
+        report::error("{}", err);
+
+    // Watch for changes. Edits to the templates only
+    // need the pages to be regenerated from the symbols
+    // we already have, while any other change requires
+    // the symbols to be extracted again.
+    //
+    // The whole corpus is extracted again, and every
+    // page is rendered again; neither is incremental.
+    auto isSourceFile = [](llvm::StringRef path)
+    {
+        auto ext = llvm::sys::path::extension(path);
+        return llvm::is_contained(std::initializer_list<llvm::StringRef>{
+            ".h", ".hh", ".hpp", ".hxx", ".h++", ".ipp", ".inl",
+            ".c", ".cc", ".cpp", ".cxx", ".c++" }, ext);
+    };
+    // The directories come from the configuration,
+    // so they are watched again when it is reloaded.
+    FileWatcher watcher;
+    std::string addonsDir;
+    auto watch = [&](ConfigImpl const& config)
+    {
+        watcher = FileWatcher();
+        // The separator keeps sibling directories
+        // such as addons-old from matching.
+        addonsDir = config->addonsDir;
+        if(! addonsDir.empty())
+            addonsDir = files::makeDirsy(addonsDir);
+        watcher.add(toolArgs.configPath.getValue());
+        if(! addonsDir.empty())
+            watcher.add(addonsDir);
+        if(toolArgs.loadCorpus.empty())
+        {
+            for(auto const& path : toolArgs.inputPaths)
+                watcher.add(path);
+            watcher.add(config->sourceRoot, isSourceFile);
+        }
+        else
+        {
+            watcher.add(toolArgs.loadCorpus.getValue());
+        }
+    };
+    watch(**config);
+    for(;;)
+    {
+        report::info("Watching for changes");
+        auto changed = watcher.wait();
+        bool const templatesOnly = ! addonsDir.empty() &&
+            std::all_of(changed.begin(), changed.end(),
+                [&](std::string const& path)
+                {
+                    return llvm::StringRef(path).startswith(addonsDir);
+                });
+        report::info("{} file(s) changed, {}", changed.size(),
+            templatesOnly ? "regenerating" : "rebuilding");
+        if(! templatesOnly)
+        {
+            auto newConfig = loadConfig();
+            if(! newConfig)
+            {
+                report::error("{}", newConfig.error());
+                continue;
+            }
+            // Before extracting, so that changes made
+            // meanwhile are seen by the next wait.
+            watch(**newConfig);
+            auto newCorpus = toolArgs.loadCorpus.empty()
+                ? buildCorpus(*newConfig)
+                : CorpusImpl::load(toolArgs.loadCorpus.getValue(), *newConfig);
+            if(! newCorpus)
+            {
+                report::error("{}", newCorpus.error());
+                continue;
+            }
+            config = std::move(newConfig);
+            corpus = std::move(newCorpus);
+            // A snapshot being loaded is not written
+            // back, or the write would be seen as a change.
+            if( toolArgs.loadCorpus.empty() ||
+                ! llvm::sys::fs::equivalent(
+                    toolArgs.loadCorpus.getValue(),
+                    toolArgs.saveCorpus.getValue()))
+                if(auto err = saveCorpus(**corpus))
+                    report::error("{}", err);
+        }
+        if(auto err = generateDocs(selected, **corpus))
+            report::error("{}", err);
+    }
 }
 
 } // mrdox
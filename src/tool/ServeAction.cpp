@@ -0,0 +1,385 @@
+//
+// Licensed under the Apache License v2.0 with LLVM Exceptions.
+// See https://llvm.org/LICENSE.txt for license information.
+// SPDX-License-Identifier: Apache-2.0 WITH LLVM-exception
+//
+// Copyright (c) 2023 Vinnie Falco (vinnie.falco@gmail.com)
+//
+// Official repository: https://github.com/cppalliance/mrdox
+//
+
+#include "ToolArgs.hpp"
+#include "lib/Lib/ConfigImpl.hpp"
+#include "lib/Lib/CorpusImpl.hpp"
+#include "lib/Support/Radix.hpp"
+#include <mrdox/Generators.hpp>
+#include <mrdox/Support/Error.hpp>
+#include <mrdox/Support/ThreadPool.hpp>
+#include <llvm/ADT/StringExtras.h>
+#include <llvm/ADT/StringMap.h>
+#include <llvm/Support/JSON.h>
+#include <llvm/Support/raw_ostream.h>
+#include <fmt/format.h>
+#include <condition_variable>
+#include <iostream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace clang {
+namespace mrdox {
+
+extern
+Expected<std::unique_ptr<Corpus>>
+buildCorpus(
+    std::shared_ptr<ConfigImpl const> const& config);
+
+namespace {
+
+namespace json = llvm::json;
+
+// JSON-RPC 2.0 error codes
+constexpr std::int64_t parseErrorCode = -32700;
+constexpr std::int64_t invalidRequestCode = -32600;
+constexpr std::int64_t methodNotFoundCode = -32601;
+constexpr std::int64_t invalidParamsCode = -32602;
+
+/*  Answers JSON-RPC requests about a corpus.
+
+    Each request and response is a single line
+    of JSON. Requests may be handled concurrently
+    and responses are written as they complete,
+    so clients match them using the request id.
+
+    The templates of each format are loaded on
+    the first render request for that format,
+    and kept for the requests which follow.
+*/
+class Server
+{
+    Corpus const& corpus_;
+    llvm::raw_ostream& os_;
+    std::mutex mutex_;
+
+    std::mutex renderMutex_;
+    llvm::StringMap<std::unique_ptr<SymbolRenderer>> renderers_;
+
+public:
+    Server(
+        Corpus const& corpus,
+        llvm::raw_ostream& os)
+        : corpus_(corpus)
+        , os_(os)
+    {
+    }
+
+    void
+    handle(
+        llvm::StringRef line)
+    {
+        auto request = json::parse(line);
+        if(! request)
+        {
+            reply(nullptr, parseErrorCode,
+                llvm::toString(request.takeError()));
+            return;
+        }
+        auto const* obj = request->getAsObject();
+        if(! obj)
+        {
+            reply(nullptr, invalidRequestCode, "request is not an object");
+            return;
+        }
+        json::Value id = nullptr;
+        if(auto const* v = obj->get("id"))
+            id = *v;
+        auto method = obj->getString("method");
+        if(! method)
+        {
+            reply(std::move(id), invalidRequestCode, "method is missing");
+            return;
+        }
+        json::Object noParams;
+        auto const* params = obj->getObject("params");
+        if(! params)
+            params = &noParams;
+
+        json::Value result = nullptr;
+        Error err;
+        if(*method == "lookup")
+            err = lookup(result, *params);
+        else if(*method == "members")
+            err = members(result, *params);
+        else if(*method == "render")
+            err = render(result, *params);
+        else if(*method == "search")
+            err = search(result, *params);
+        else
+        {
+            reply(std::move(id), methodNotFoundCode,
+                fmt::format("unknown method \"{}\"", method->str()));
+            return;
+        }
+        if(err)
+        {
+            reply(std::move(id), invalidParamsCode, err.reason());
+            return;
+        }
+        write(json::Object{
+            { "jsonrpc", "2.0" },
+            { "id", std::move(id) },
+            { "result", std::move(result) } });
+    }
+
+private:
+    void
+    write(json::Value response)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        os_ << response << '\n';
+        os_.flush();
+    }
+
+    void
+    reply(
+        json::Value id,
+        std::int64_t code,
+        std::string message)
+    {
+        write(json::Object{
+            { "jsonrpc", "2.0" },
+            { "id", std::move(id) },
+            { "error", json::Object{
+                { "code", code },
+                { "message", std::move(message) } } } });
+    }
+
+    json::Value
+    toJSON(Info const& I) const
+    {
+        std::string temp;
+        return json::Object{
+            { "id", toBase16(I.id) },
+            { "kind", toString(I.Kind).str() },
+            { "name", corpus_.getFullyQualifiedName(I, temp) } };
+    }
+
+    // Return the symbol named by "id" or "name"
+    Expected<Info const*>
+    findSymbol(json::Object const& params) const
+    {
+        if(auto id = params.getString("id"))
+        {
+            std::string bytes;
+            if(id->size() != 2 * SymbolID().size() ||
+                ! llvm::tryGetFromHex(*id, bytes))
+                return formatError("\"{}\" is not a symbol ID", id->str());
+            if(auto I = corpus_.find(SymbolID(bytes.data())))
+                return I;
+            return formatError("no symbol has the ID \"{}\"", id->str());
+        }
+        if(auto name = params.getString("name"))
+        {
+            // Overloads share a name, use the first
+            auto found = corpus_.findByName(*name);
+            if(! found.empty())
+                return found.front();
+            return formatError("no symbol is named \"{}\"", name->str());
+        }
+        return formatError("the id or name parameter is missing");
+    }
+
+    Error
+    lookup(
+        json::Value& result,
+        json::Object const& params)
+    {
+        auto I = findSymbol(params);
+        if(! I)
+            return I.error();
+        result = toJSON(**I);
+        return Error::success();
+    }
+
+    Error
+    members(
+        json::Value& result,
+        json::Object const& params)
+    {
+        auto I = findSymbol(params);
+        if(! I)
+            return I.error();
+        json::Array list;
+        visit(**I,
+            [&]<class T>(T const& J)
+            {
+                if constexpr(
+                    T::isNamespace() ||
+                    T::isRecord() ||
+                    T::isSpecialization())
+                {
+                    corpus_.traverse(J,
+                        [&](Info const& M)
+                        {
+                            list.push_back(toJSON(M));
+                        });
+                }
+            });
+        result = std::move(list);
+        return Error::success();
+    }
+
+    // Return the renderer for a generator,
+    // which is made on first use.
+    Expected<SymbolRenderer*>
+    getRenderer(
+        Generator const& generator)
+    {
+        std::lock_guard<std::mutex> lock(renderMutex_);
+        auto& renderer = renderers_[generator.id()];
+        if(! renderer)
+        {
+            auto made = generator.makeSymbolRenderer(corpus_);
+            if(! made)
+                return made.error();
+            renderer = std::move(*made);
+        }
+        return renderer.get();
+    }
+
+    Error
+    render(
+        json::Value& result,
+        json::Object const& params)
+    {
+        auto I = findSymbol(params);
+        if(! I)
+            return I.error();
+        auto format = params.getString("format");
+        if(! format)
+            return formatError("the format parameter is missing");
+        auto generator = getGenerators().find(*format);
+        if(! generator)
+            return formatError("the Generator \"{}\" was not found", format->str());
+        auto renderer = getRenderer(*generator);
+        if(! renderer)
+            return renderer.error();
+        std::string text;
+        if(auto err = (*renderer)->render(text, **I))
+            return err;
+        result = json::Object{
+            { "text", std::move(text) } };
+        return Error::success();
+    }
+
+    Error
+    search(
+        json::Value& result,
+        json::Object const& params)
+    {
+        auto prefix = params.getString("prefix");
+        if(! prefix)
+            return formatError("the prefix parameter is missing");
+        std::size_t limit = 100;
+        if(auto n = params.getInteger("limit"))
+        {
+            if(*n < 0)
+                return formatError("the limit parameter is negative");
+            limit = static_cast<std::size_t>(*n);
+        }
+        bool ignoreCase = false;
+        if(auto b = params.getBoolean("ignoreCase"))
+            ignoreCase = *b;
+        json::Array list;
+        for(Info const* I : corpus_.findByPrefix(
+                *prefix, ignoreCase, limit))
+            list.push_back(toJSON(*I));
+        result = std::move(list);
+        return Error::success();
+    }
+};
+
+} // (anon)
+
+Error
+DoServeAction()
+{
+    ThreadPool threadPool(toolArgs.concurrency);
+
+    // Load configuration file
+    if(toolArgs.configPath.empty())
+        return formatError("the config path argument is missing");
+    auto config = loadConfigFile(
+        toolArgs.configPath,
+        toolArgs.addonsDir,
+        toolArgs.ignoreMappingFailures.getValue() ?
+            "ignore-failures: true\n" : "",
+        nullptr,
+        threadPool);
+    if(! config)
+        return config.error();
+
+    auto corpus = toolArgs.loadCorpus.empty()
+        ? buildCorpus(*config)
+        : CorpusImpl::load(toolArgs.loadCorpus.getValue(), *config);
+    if(! corpus)
+        return corpus.error();
+
+    Server server(**corpus, llvm::outs());
+    report::info("Serving {} symbols", (*corpus)->index().size());
+
+    // Requests are read on this thread and
+    // answered on the thread pool. Reading stops
+    // while too many requests are waiting, so a
+    // client which sends faster than requests
+    // are answered does not queue without bound.
+    std::size_t const maxPending =
+        4 * threadPool.getThreadCount();
+    std::size_t pending = 0;
+    std::mutex mutex;
+    std::condition_variable cv;
+    auto const done = [&]
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --pending;
+        }
+        cv.notify_one();
+    };
+
+    TaskGroup taskGroup(threadPool);
+    std::string line;
+    while(std::getline(std::cin, line))
+    {
+        if(llvm::StringRef(line).trim().empty())
+            continue;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&]{ return pending < maxPending; });
+            ++pending;
+        }
+        taskGroup.async(
+            [&server, &done, line = std::move(line)]
+            {
+                try
+                {
+                    server.handle(line);
+                }
+                catch(...)
+                {
+                    done();
+                    throw;
+                }
+                done();
+            });
+    }
+    auto errors = taskGroup.wait();
+    if(! errors.empty())
+        return Error(errors);
+    return Error::success();
+}
+
+} // mrdox
+} // clang
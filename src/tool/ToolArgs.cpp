@@ -36,9 +36,27 @@ ADDONS:
     2. The directory containing the mrdox tool executable, otherwise
     3. The environment variable MRDOX_ADDONS_DIR if set.
 
+ACTIONS:
+    diff    Compare a snapshot written by --save-corpus with the
+            symbols from a fresh run or from --load-corpus, and
+            write the added, removed, and changed symbols to the
+            --output file.
+
+    serve   Build or load the symbols once, then answer JSON-RPC
+            requests, one per line, on stdin and stdout.
+
+    bench   Render the single page reference for each --format
+            with handlebars.js, with handlebars.js and eager
+            fields, and with the native template engine. Report
+            the time each took, and check that the output is
+            identical.
+
 EXAMPLES:
     mrdox .. ( compile-commands )
     mrdox --format adoc compile_commands.json
+    mrdox diff --base=old.snapshot --output=diff.json compile_commands.json
+    mrdox serve --load-corpus=symbols.snapshot
+    mrdox bench --format=adoc,html --load-corpus=symbols.snapshot
 )")
 
 //
@@ -62,6 +80,17 @@ EXAMPLES:
     llvm::cl::init(0),
     llvm::cl::cat(commonCat))
 
+, memoryReport(
+    "memory-report",
+    llvm::cl::desc("Print a per-phase memory report, and write it as JSON to this file."),
+    llvm::cl::cat(commonCat))
+
+, memoryLimit(
+    "memory-limit",
+    llvm::cl::desc("Run one task at a time while memory usage exceeds this many megabytes (0 for no limit)."),
+    llvm::cl::init(0),
+    llvm::cl::cat(commonCat))
+
 //
 // Tool options
 //
@@ -77,7 +106,7 @@ EXAMPLES:
 
 , formatType(
     "format",
-    llvm::cl::desc("Format for the emitted documentation (\"adoc\", \"xml\", or \"html\")."),
+    llvm::cl::desc("Format for the emitted documentation (\"adoc\", \"xml\", or \"html\"). Separate several formats with commas to generate all of them from one extraction."),
     llvm::cl::init("adoc"))
 
 , ignoreMappingFailures(
@@ -85,6 +114,28 @@ EXAMPLES:
     llvm::cl::desc("Continue if files are not mapped correctly."),
     llvm::cl::init(true))
 
+, saveCorpus(
+    "save-corpus",
+    llvm::cl::desc("Write a snapshot of the extracted symbols to this file."))
+
+, loadCorpus(
+    "load-corpus",
+    llvm::cl::desc("Load the symbols from a snapshot instead of running the extraction."))
+
+, watch(
+    "watch",
+    llvm::cl::desc("Keep running, and regenerate the documentation when the sources, templates, or configuration change."),
+    llvm::cl::init(false))
+
+, diffBase(
+    "base",
+    llvm::cl::desc("The snapshot of the old symbols, for the diff action."))
+
+, diffFormat(
+    "diff-format",
+    llvm::cl::desc("The format of the diff output, json or xml."),
+    llvm::cl::init("json"))
+
 , inputPaths(
     "inputs",
     llvm::cl::Sink,
@@ -107,6 +158,13 @@ hideForeignOptions()
         std::addressof(inputPaths),
         &formatType,
         &ignoreMappingFailures,
+        &saveCorpus,
+        &loadCorpus,
+        &watch,
+        &diffBase,
+        &diffFormat,
+        &memoryReport,
+        &memoryLimit,
     });
 
     // Really hide the clang/llvm default
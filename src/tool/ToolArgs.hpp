@@ -34,11 +34,18 @@ public:
     llvm::cl::opt<std::string>  addonsDir;
     llvm::cl::opt<unsigned>     reportLevel;
     llvm::cl::opt<unsigned>     concurrency;
+    llvm::cl::opt<std::string>  memoryReport;
+    llvm::cl::opt<unsigned>     memoryLimit;
 
     llvm::cl::opt<std::string>  configPath;
     llvm::cl::opt<std::string>  outputPath;
     llvm::cl::opt<std::string>  formatType;
     llvm::cl::opt<bool>         ignoreMappingFailures;
+    llvm::cl::opt<std::string>  saveCorpus;
+    llvm::cl::opt<std::string>  loadCorpus;
+    llvm::cl::opt<bool>         watch;
+    llvm::cl::opt<std::string>  diffBase;
+    llvm::cl::opt<std::string>  diffFormat;
     llvm::cl::list<std::string> inputPaths;
 
     // Hide all options which don't belong to us
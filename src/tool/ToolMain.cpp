@@ -20,6 +20,8 @@
 #include <llvm/Support/PrettyStackTrace.h>
 #include <llvm/Support/Signals.h>
 #include <stdlib.h>
+#include <string_view>
+#include <vector>
 
 extern int main(int argc, char const** argv);
 
@@ -28,6 +30,9 @@ namespace mrdox {
 
 extern int DoTestAction();
 extern Error DoGenerateAction();
+extern Error DoDiffAction();
+extern Error DoServeAction();
+extern Error DoBenchAction();
 
 void
 print_version(llvm::raw_ostream& os)
@@ -50,9 +55,23 @@ int mrdox_main(int argc, char const** argv)
     llvm::sys::PrintStackTraceOnErrorSignal(argv[0]);
     llvm::cl::SetVersionPrinter(&print_version);
 
+    // The first argument may name an action
+    // other than generating the reference.
+    std::vector<char const*> args(argv, argv + argc);
+    std::string_view action;
+    if(args.size() > 1 && (
+        std::string_view(args[1]) == "diff" ||
+        std::string_view(args[1]) == "serve" ||
+        std::string_view(args[1]) == "bench"))
+    {
+        action = args[1];
+        args.erase(args.begin() + 1);
+    }
+
     toolArgs.hideForeignOptions();
     if(! llvm::cl::ParseCommandLineOptions(
-            argc, argv, toolArgs.usageText))
+            static_cast<int>(args.size()), args.data(),
+            toolArgs.usageText))
         return EXIT_FAILURE;
 
     // Apply reportLevel
@@ -73,9 +92,27 @@ int mrdox_main(int argc, char const** argv)
         return EXIT_FAILURE;
     }
 
-    // Generate
-    if(auto err = DoGenerateAction())
-        report::error("Generating reference failed: ", err);
+    if(action == "diff")
+    {
+        if(auto err = DoDiffAction())
+            report::error("Comparing symbols failed: {}", err);
+    }
+    else if(action == "serve")
+    {
+        if(auto err = DoServeAction())
+            report::error("Serving symbols failed: {}", err);
+    }
+    else if(action == "bench")
+    {
+        if(auto err = DoBenchAction())
+            report::error("Comparing template engines failed: {}", err);
+    }
+    else
+    {
+        // Generate
+        if(auto err = DoGenerateAction())
+            report::error("Generating reference failed: ", err);
+    }
 
     if( report::results.errorCount > 0 ||
         report::results.fatalCount > 0)